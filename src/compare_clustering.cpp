@@ -1,20 +1,6 @@
 #include "compare_clustering.hpp"
 
-int nb_columns(const std::string &line)
-{
-    /*!
-     * @brief Enables to count the number of columns from a header
-     * 
-     * @param line The header line of the considered file
-     * 
-     * @return The number of columns 
-     */
-
-	return std::count_if(line.begin(), line.end(),
-                                [](unsigned char c){ return std::isspace(c); }) + 2;
-}
-
-void compare_clustering(std::string file_to_read, int k)
+void compare_clustering(std::string file_to_read, int k, int silhouette_sample, KMeansMode mode, KMeansInit init)
 {
     /*!
      * @brief From a file given as entry and an integer k for the number of 
@@ -22,39 +8,27 @@ void compare_clustering(std::string file_to_read, int k)
      * 
      * @param file_to_read Path to the data
      * @param k Number of clusters to draw
+     * @param silhouette_sample Number of points from which silhouettes are 
+     * estimated, 0 meaning that they are computed exactly
+     * @param mode The kmeans variant, see Cloud::kmeans
+     * @param init How the kmeans centers are initialized
      * 
      */
 
-	// get points from datafile
-
-	std::ifstream is(file_to_read);
-	assert(is.is_open());
-
-	std::string header_line;
-	std::getline(is, header_line);
-
-	const int d = nb_columns(header_line) - 1;
-    Point::d = d;
+	// get points from datafile, whose first row gives the dimension
 
-    std::vector<Point*> points = Point::read_points_from_file(file_to_read, d);
-    int n = points.size();
+    PointSet* point_set = PointSet::read_from_file(file_to_read);
+    std::vector<Point*> points = point_set->make_points();
 
     // run MST clustering 
 
-    std::chrono::steady_clock::time_point graph_creation = std::chrono::steady_clock::now();
-
-    std::cout << "\nCreating graph...";
-    Graph* g = new Graph(points);
-    std::cout << "[OK]" << std::endl;
-
-    std::chrono::steady_clock::time_point kruskal_algo = std::chrono::steady_clock::now();
+    // the complete graph over the points is never built, distances are computed on the fly
+    std::chrono::steady_clock::time_point mst_algo = std::chrono::steady_clock::now();
 
-    KruskalAlgorithm kruskal = KruskalAlgorithm(g);
-    kruskal.compute_mst();
+    DensePrimAlgorithm dense_prim = DensePrimAlgorithm(points);
+    dense_prim.compute_mst();
 
-    std::chrono::steady_clock::time_point kruskal_clustering = std::chrono::steady_clock::now();
-
-    std::unordered_map<Node*, Node*> clusters = kruskal.compute_clustering(k);
+    std::unordered_map<Node*, Node*> clusters = dense_prim.compute_clustering(k);
 
     std::chrono::steady_clock::time_point mst_end = std::chrono::steady_clock::now();
 
@@ -64,37 +38,36 @@ void compare_clustering(std::string file_to_read, int k)
 
     std::cout << "\nCreating cloud...";
 
-    Cloud cloud = Cloud(d, n, k);
-
-    int label = 0;
-    for (int i = 0; i < n; i ++) {
-        cloud.add_point(*points[i], label);
-        label = (label+1) % k;
-    }
+    // the cloud views the coordinates of the points, which are not copied
+    Cloud cloud(point_set, k);
 
     std::cout << "[OK]" << std::endl;
 
     std::chrono::steady_clock::time_point kmeans_algo = std::chrono::steady_clock::now();
 
-    cloud.kmeans();
+    cloud.kmeans(mode, init);
 
     std::chrono::steady_clock::time_point kmeans_end = std::chrono::steady_clock::now();
 
     // comparison
 
-    std::cout << "\nTotal time spent by MST clustering including graph creation: ";
-    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(mst_end - graph_creation).count() << " µs" << std::endl;
-
-    std::cout << "Total time spent by MST clustering: ";
-    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(mst_end - kruskal_algo).count() << " µs" << std::endl;
+    std::cout << "\nTotal time spent by MST clustering: ";
+    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(mst_end - mst_algo).count() << " µs" << std::endl;
 
     double mst_variance = intracluster_variance(clusters);
     std::cout << "Intracluster variance in MST: ";
     std::cout << mst_variance << std::endl;
 
-    double mst_silhouette = silhouette(clusters);
-    std::cout << "Silhouette in MST: ";
-    std::cout << mst_silhouette << std::endl;
+    if (silhouette_sample > 0) {
+        SilhouetteEstimate mst_silhouette = sampled_silhouette(clusters, silhouette_sample);
+        std::cout << "Silhouette in MST: ";
+        std::cout << mst_silhouette.value << " +/- " << mst_silhouette.half_width;
+        std::cout << " (95% confidence, " << mst_silhouette.sample_size << " sampled points)" << std::endl;
+    } else {
+        double mst_silhouette = silhouette(clusters);
+        std::cout << "Silhouette in MST: ";
+        std::cout << mst_silhouette << std::endl;
+    }
 
     std::cout << "\nTotal time spent by kmeans including cloud creation: ";
     std::cout << std::chrono::duration_cast<std::chrono::microseconds>(kmeans_end - cloud_creation).count() << " µs" << std::endl;
@@ -106,14 +79,26 @@ void compare_clustering(std::string file_to_read, int k)
     std::cout << "Intracluster variance in kmeans: ";
     std::cout << kmeans_variance << std::endl;
 
-    double kmeans_silhouette = cloud.silhouette();
-    std::cout << "Silhouette in kmeans: ";
-    std::cout << kmeans_silhouette << std::endl;
+    if (silhouette_sample > 0) {
+        SilhouetteEstimate kmeans_silhouette = cloud.sampled_silhouette(silhouette_sample);
+        std::cout << "Silhouette in kmeans: ";
+        std::cout << kmeans_silhouette.value << " +/- " << kmeans_silhouette.half_width;
+        std::cout << " (95% confidence, " << kmeans_silhouette.sample_size << " sampled points)" << std::endl;
+    } else {
+        double kmeans_silhouette = cloud.silhouette();
+        std::cout << "Silhouette in kmeans: ";
+        std::cout << kmeans_silhouette << std::endl;
+    }
+
+    for (Point* p : points) {
+        delete p;
+    }
+    delete point_set;
 
     return;
 }
 
-void compare_inconsistency(std::string file_to_read, double cutoff)
+void compare_inconsistency(std::string file_to_read, double cutoff, KMeansMode mode, KMeansInit init)
 {
     /*!
      * @brief From a file given as entry and an integer k for the number of 
@@ -121,39 +106,25 @@ void compare_inconsistency(std::string file_to_read, double cutoff)
      * 
      * @param file_to_read Path to the data
      * @param k Number of clusters to draw
+     * @param mode The kmeans variant, see Cloud::kmeans
+     * @param init How the kmeans centers are initialized
      * 
      */
 
-	// get points from datafile
-
-	std::ifstream is(file_to_read);
-	assert(is.is_open());
-
-	std::string header_line;
-	std::getline(is, header_line);
+	// get points from datafile, whose first row gives the dimension
 
-	const int d = nb_columns(header_line) - 1;
-    Point::d = d;
-
-    std::vector<Point*> points = Point::read_points_from_file(file_to_read, d);
-    int n = points.size();
+    PointSet* point_set = PointSet::read_from_file(file_to_read);
+    std::vector<Point*> points = point_set->make_points();
 
     // run Inconsistency method 
 
-    std::chrono::steady_clock::time_point graph_creation = std::chrono::steady_clock::now();
-
-    std::cout << "\nCreating graph...";
-    Graph* g = new Graph(points);
-    std::cout << "[OK]" << std::endl;
-
-    std::chrono::steady_clock::time_point kruskal_algo = std::chrono::steady_clock::now();
-
-    KruskalAlgorithm kruskal = KruskalAlgorithm(g);
-    kruskal.compute_mst();
+    // the complete graph over the points is never built, distances are computed on the fly
+    std::chrono::steady_clock::time_point mst_algo = std::chrono::steady_clock::now();
 
-    std::chrono::steady_clock::time_point inc_clustering = std::chrono::steady_clock::now();
+    DensePrimAlgorithm dense_prim = DensePrimAlgorithm(points);
+    dense_prim.compute_mst();
 
-    std::unordered_map<Node*, Node*> clusters = kruskal.compute_clustering(cutoff);
+    std::unordered_map<Node*, Node*> clusters = dense_prim.compute_clustering(cutoff);
 
     std::unordered_map<Node*, int> clusters_size;
     for (auto kv : clusters) {
@@ -181,29 +152,21 @@ void compare_inconsistency(std::string file_to_read, double cutoff)
 
     std::cout << "\nCreating cloud...";
 
-    Cloud cloud = Cloud(d, n, clusters.size());
-
-    int label = 0;
-    for (int i = 0; i < n; i ++) {
-        cloud.add_point(*points[i], label);
-        label = (label+1) % clusters.size();
-    }
+    // the cloud views the coordinates of the points, which are not copied
+    Cloud cloud(point_set, clusters.size());
 
     std::cout << "[OK]" << std::endl;
 
     std::chrono::steady_clock::time_point kmeans_algo = std::chrono::steady_clock::now();
 
-    cloud.kmeans();
+    cloud.kmeans(mode, init);
 
     std::chrono::steady_clock::time_point kmeans_end = std::chrono::steady_clock::now();
 
     // comparison
 
-    std::cout << "\nTotal time spent by Inconsistency clustering including graph creation: ";
-    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(inc_end - graph_creation).count() << " µs" << std::endl;
-
-    std::cout << "Total time spent by Inconsistency clustering: ";
-    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(inc_end - kruskal_algo).count() << " µs" << std::endl;
+    std::cout << "\nTotal time spent by Inconsistency clustering: ";
+    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(inc_end - mst_algo).count() << " µs" << std::endl;
 
     double inc_variance = intracluster_variance(clusters);
     std::cout << "Intracluster variance with Inconsistency clustering: ";
@@ -219,5 +182,42 @@ void compare_inconsistency(std::string file_to_read, double cutoff)
     std::cout << "Intracluster variance in kmeans: ";
     std::cout << kmeans_variance << std::endl;
 
+    for (Point* p : points) {
+        delete p;
+    }
+    delete point_set;
+
     return;
-}
\ No newline at end of file
+}
+
+void stream_clustering(std::string file_to_read, int k, int chunk_size)
+{
+    /*!
+     * @brief Clusters the points of a file with streaming kmeans, which only 
+     * holds \p chunk_size points in memory at once, so that files larger 
+     * than memory can be processed
+     * 
+     * @param file_to_read Path to the data, one point per row
+     * @param k Number of clusters to draw
+     * @param chunk_size Number of points read at once
+     * 
+     */
+
+    PointStream stream(file_to_read);
+
+    std::chrono::steady_clock::time_point kmeans_algo = std::chrono::steady_clock::now();
+
+    Cloud cloud(stream.get_dim(), chunk_size, k);
+    cloud.kmeans_stream(stream);
+
+    std::chrono::steady_clock::time_point kmeans_end = std::chrono::steady_clock::now();
+
+    std::cout << "\nTotal time spent by streaming kmeans: ";
+    std::cout << std::chrono::duration_cast<std::chrono::microseconds>(kmeans_end - kmeans_algo).count() << " µs" << std::endl;
+
+    // the cloud only holds the first chunk of the file
+    std::cout << "Intracluster variance in streaming kmeans, over the first " << cloud.get_n() << " points: ";
+    std::cout << cloud.intracluster_variance() << std::endl;
+
+    return;
+}
@@ -1,8 +1,8 @@
 #pragma once 
 
-#include "mst_kruskal.hpp"
+#include "mst_dense_prim.hpp"
 #include "kmeans.hpp"
 
-int nb_columns(const std::string &line);
-void compare_clustering(std::string file_to_read, int k);
-void compare_inconsistency(std::string file_to_read, double cutoff);
\ No newline at end of file
+void compare_clustering(std::string file_to_read, int k, int silhouette_sample = 0, KMeansMode mode = KMeansMode::Lloyd, KMeansInit init = KMeansInit::Forgy);
+void compare_inconsistency(std::string file_to_read, double cutoff, KMeansMode mode = KMeansMode::Lloyd, KMeansInit init = KMeansInit::Forgy);
+void stream_clustering(std::string file_to_read, int k, int chunk_size = KMEANS_STREAM_CHUNK);
@@ -0,0 +1,78 @@
+#include "csr_graph.hpp"
+
+#include <utility>
+
+CSRGraph::CSRGraph()
+{
+    /*!
+     * @brief Builds an empty CSR graph
+     *
+     */
+
+    this->n = 0;
+    this->m = 0;
+    this->offsets.assign(1, 0);
+}
+
+CSRGraph::CSRGraph(int n, std::vector<WeightedEdge> edges)
+{
+    /*!
+     * @brief Builds the CSR representation of an undirected graph from its
+     * list of edges, using a counting sort on the endpoints
+     *
+     * @param n The number of nodes, whose identifiers are in [0, n)
+     * @param edges The edges of the graph, where edges[i].id must be equal to i, 
+     * which are moved into the view
+     *
+     * @note Each edge appears twice in the adjacency arrays, once for each endpoint
+     *
+     */
+
+    this->n = n;
+    this->m = edges.size();
+    this->edges = std::move(edges);
+
+    // counting the degree of each node
+    this->offsets.assign(n+1, 0);
+    for (const WeightedEdge& e : this->edges) {
+        this->offsets[e.u+1] += 1;
+        this->offsets[e.v+1] += 1;
+    }
+
+    for (int u = 0; u < n; u ++) {
+        this->offsets[u+1] += this->offsets[u];
+    }
+
+    // filling the slots of each node
+    this->targets.resize(2*this->m);
+    this->weights.resize(2*this->m);
+    this->edge_ids.resize(2*this->m);
+
+    std::vector<int> next_slot(this->offsets.begin(), this->offsets.end()-1);
+
+    for (const WeightedEdge& e : this->edges) {
+        int slot = next_slot[e.u]++;
+        this->targets[slot] = e.v;
+        this->weights[slot] = e.weight;
+        this->edge_ids[slot] = e.id;
+
+        slot = next_slot[e.v]++;
+        this->targets[slot] = e.u;
+        this->weights[slot] = e.weight;
+        this->edge_ids[slot] = e.id;
+    }
+}
+
+int CSRGraph::degree(node_id_t u) const
+{
+    /*!
+     * @brief Returns the number of edges connected to node \p u
+     *
+     * @param u The identifier of the node
+     *
+     * @return The degree of \p u
+     *
+     */
+
+    return this->offsets[u+1] - this->offsets[u];
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "edge.hpp"
+
+#include <vector>
+
+struct WeightedEdge
+{
+    /*!
+     * @struct Flat description of an edge, whose endpoints are given by
+     * their identifiers in the graph
+     *
+     */
+
+    edge_weight_t weight;
+    node_id_t u;
+    node_id_t v;
+    edge_id_t id;
+};
+
+class CSRGraph
+{
+    /*!
+     * @class Compressed Sparse Row representation of a graph. The neighbors
+     * of node \p u are stored contiguously in the slots [offsets[u], offsets[u+1])
+     * of the targets, weights and edge_ids arrays, all indexed by node_id_t
+     *
+     */
+
+    public:
+        int n;
+        int m;
+
+        std::vector<int> offsets;
+        std::vector<node_id_t> targets;
+        std::vector<edge_weight_t> weights;
+        std::vector<edge_id_t> edge_ids;
+
+        std::vector<WeightedEdge> edges; // indexed by edge_id_t
+
+        CSRGraph();
+        CSRGraph(int n, std::vector<WeightedEdge> edges);
+
+        int degree(node_id_t u) const;
+};
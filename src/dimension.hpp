@@ -0,0 +1,31 @@
+#pragma once
+
+#include <type_traits>
+
+template <typename Function>
+auto dispatch_dimension(int d, Function f) -> decltype(f(std::integral_constant<int, 0>()))
+{
+    /*!
+     * @brief Calls \p f with the dimension as a compile-time constant when it is
+     * one of the common ones, so that loops over the coordinates have a fixed
+     * trip count and can be fully unrolled
+     *
+     * @param d The dimension of the points
+     * @param f The kernel, called with a std::integral_constant<int, D>, where
+     * D = 0 stands for any other dimension, which must then be read from \p d
+     *
+     * @return The value returned by \p f
+     *
+     */
+
+    switch (d) {
+        case 2: return f(std::integral_constant<int, 2>());
+        case 3: return f(std::integral_constant<int, 3>());
+        case 4: return f(std::integral_constant<int, 4>());
+        case 8: return f(std::integral_constant<int, 8>());
+        case 10: return f(std::integral_constant<int, 10>());
+        case 16: return f(std::integral_constant<int, 16>());
+        case 32: return f(std::integral_constant<int, 32>());
+        default: return f(std::integral_constant<int, 0>());
+    }
+}
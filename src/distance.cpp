@@ -0,0 +1,322 @@
+#include "distance.hpp"
+#include "dimension.hpp"
+
+#include <cstddef>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define DISTANCE_X86_KERNELS
+// some GCC versions report _mm512_undefined_pd, used by the avx512
+// reductions, as reading an uninitialized variable
+#ifndef __clang__
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#ifndef __clang__
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+namespace
+{
+
+template <int D>
+inline double squared_distance_scalar(const double* x, const double* y, int d)
+{
+    /*!
+     * @brief Portable kernel, used when no vector extension is available
+     *
+     */
+
+    const int dim = (D > 0) ? D : d;
+
+    double dist = 0.0;
+    for (int j = 0; j < dim; j ++) {
+        double diff = x[j] - y[j];
+        dist += diff*diff;
+    }
+
+    return dist;
+}
+
+template <int D>
+void squared_distances_scalar(const double* x, const double* rows, int count, int d, double* out)
+{
+    const int dim = (D > 0) ? D : d;
+
+    for (int i = 0; i < count; i ++) {
+        out[i] = squared_distance_scalar<D>(x, rows + (size_t) i*dim, dim);
+    }
+}
+
+#ifdef DISTANCE_X86_KERNELS
+
+template <int D>
+__attribute__((target("avx2,fma")))
+inline __m256d squared_differences_avx2(const double* x, const double* y, int d)
+{
+    /*!
+     * @brief AVX2 kernel, four coordinates at a time, the last d%4 ones
+     * being loaded with a mask. The squared distance is the sum of the four
+     * values returned, which are not reduced yet.
+     *
+     */
+
+    const int dim = (D > 0) ? D : d;
+
+    __m256d acc = _mm256_setzero_pd();
+
+    int j = 0;
+    for (; j + 4 <= dim; j += 4) {
+        __m256d diff = _mm256_sub_pd(_mm256_loadu_pd(x + j), _mm256_loadu_pd(y + j));
+        acc = _mm256_fmadd_pd(diff, diff, acc);
+    }
+
+    if (j < dim) {
+        int left = dim - j;
+        __m256i mask = _mm256_set_epi64x(0, -(left > 2), -(left > 1), -1);
+        __m256d diff = _mm256_sub_pd(_mm256_maskload_pd(x + j, mask), _mm256_maskload_pd(y + j, mask));
+        acc = _mm256_fmadd_pd(diff, diff, acc);
+    }
+
+    return acc;
+}
+
+__attribute__((target("avx2,fma")))
+inline double reduce_avx2(__m256d acc)
+{
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(acc), _mm256_extractf128_pd(acc, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+template <int D>
+__attribute__((target("avx2,fma")))
+inline double squared_distance_avx2(const double* x, const double* y, int d)
+{
+    return reduce_avx2(squared_differences_avx2<D>(x, y, d));
+}
+
+template <int D>
+__attribute__((target("avx2,fma")))
+void squared_distances_avx2(const double* x, const double* rows, int count, int d, double* out)
+{
+    /*!
+     * @brief Handles four rows at a time, whose partial sums are reduced
+     * together with horizontal additions
+     *
+     */
+
+    const int dim = (D > 0) ? D : d;
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const double* y = rows + (size_t) i*dim;
+        __m256d h01 = _mm256_hadd_pd(squared_differences_avx2<D>(x, y, dim), squared_differences_avx2<D>(x, y + dim, dim));
+        __m256d h23 = _mm256_hadd_pd(squared_differences_avx2<D>(x, y + 2*dim, dim), squared_differences_avx2<D>(x, y + 3*dim, dim));
+
+        __m256d sum = _mm256_add_pd(_mm256_permute2f128_pd(h01, h23, 0x20), _mm256_permute2f128_pd(h01, h23, 0x31));
+        _mm256_storeu_pd(out + i, sum);
+    }
+
+    for (; i < count; i ++) {
+        out[i] = squared_distance_avx2<D>(x, rows + (size_t) i*dim, dim);
+    }
+}
+
+template <int D>
+__attribute__((target("avx512f")))
+inline __m512d squared_differences_avx512(const double* x, const double* y, int d)
+{
+    /*!
+     * @brief AVX-512 kernel, eight coordinates at a time, the last d%8 ones
+     * being loaded with a mask. The squared distance is the sum of the eight
+     * values returned, which are not reduced yet.
+     *
+     */
+
+    const int dim = (D > 0) ? D : d;
+
+    __m512d acc = _mm512_setzero_pd();
+
+    int j = 0;
+    for (; j + 8 <= dim; j += 8) {
+        __m512d diff = _mm512_sub_pd(_mm512_loadu_pd(x + j), _mm512_loadu_pd(y + j));
+        acc = _mm512_fmadd_pd(diff, diff, acc);
+    }
+
+    if (j < dim) {
+        __mmask8 mask = (__mmask8) ((1u << (dim - j)) - 1);
+        __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + j), _mm512_maskz_loadu_pd(mask, y + j));
+        acc = _mm512_fmadd_pd(diff, diff, acc);
+    }
+
+    return acc;
+}
+
+template <int D>
+__attribute__((target("avx512f")))
+inline double squared_distance_avx512(const double* x, const double* y, int d)
+{
+    return _mm512_reduce_add_pd(squared_differences_avx512<D>(x, y, d));
+}
+
+template <int D>
+__attribute__((target("avx512f")))
+void squared_distances_avx512(const double* x, const double* rows, int count, int d, double* out)
+{
+    /*!
+     * @brief Handles eight rows at a time, whose partial sums are reduced
+     * together by a transposition, rather than one horizontal sum per row
+     *
+     */
+
+    const int dim = (D > 0) ? D : d;
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const double* y = rows + (size_t) i*dim;
+
+        // pairs of rows, each 128-bit lane holding a partial sum of both
+        __m512d pairs[4];
+        for (int p = 0; p < 4; p ++) {
+            __m512d a = squared_differences_avx512<D>(x, y + (2*p)*dim, dim);
+            __m512d b = squared_differences_avx512<D>(x, y + (2*p+1)*dim, dim);
+            pairs[p] = _mm512_add_pd(_mm512_unpacklo_pd(a, b), _mm512_unpackhi_pd(a, b));
+        }
+
+        // quadruples of rows, then the eight rows in order
+        __m512d q0 = _mm512_add_pd(_mm512_shuffle_f64x2(pairs[0], pairs[1], 0x88), _mm512_shuffle_f64x2(pairs[0], pairs[1], 0xDD));
+        __m512d q1 = _mm512_add_pd(_mm512_shuffle_f64x2(pairs[2], pairs[3], 0x88), _mm512_shuffle_f64x2(pairs[2], pairs[3], 0xDD));
+        __m512d sum = _mm512_add_pd(_mm512_shuffle_f64x2(q0, q1, 0x88), _mm512_shuffle_f64x2(q0, q1, 0xDD));
+
+        _mm512_storeu_pd(out + i, sum);
+    }
+
+    for (; i < count; i ++) {
+        out[i] = squared_distance_avx512<D>(x, rows + (size_t) i*dim, dim);
+    }
+}
+
+#endif
+
+// entry points of each instruction set, which select the kernel of the dimension
+
+double squared_distance_any_scalar(const double* x, const double* y, int d)
+{
+    return dispatch_dimension(d, [&](auto D) { return squared_distance_scalar<decltype(D)::value>(x, y, d); });
+}
+
+void squared_distances_any_scalar(const double* x, const double* rows, int count, int d, double* out)
+{
+    dispatch_dimension(d, [&](auto D) { squared_distances_scalar<decltype(D)::value>(x, rows, count, d, out); });
+}
+
+#ifdef DISTANCE_X86_KERNELS
+
+double squared_distance_any_avx2(const double* x, const double* y, int d)
+{
+    return dispatch_dimension(d, [&](auto D) { return squared_distance_avx2<decltype(D)::value>(x, y, d); });
+}
+
+void squared_distances_any_avx2(const double* x, const double* rows, int count, int d, double* out)
+{
+    dispatch_dimension(d, [&](auto D) { squared_distances_avx2<decltype(D)::value>(x, rows, count, d, out); });
+}
+
+double squared_distance_any_avx512(const double* x, const double* y, int d)
+{
+    return dispatch_dimension(d, [&](auto D) { return squared_distance_avx512<decltype(D)::value>(x, y, d); });
+}
+
+void squared_distances_any_avx512(const double* x, const double* rows, int count, int d, double* out)
+{
+    dispatch_dimension(d, [&](auto D) { squared_distances_avx512<decltype(D)::value>(x, rows, count, d, out); });
+}
+
+#endif
+
+const DistanceKernels& selected_kernels()
+{
+    /*!
+     * @brief Returns the widest kernels supported by the running processor,
+     * picked on the first call
+     *
+     */
+
+    static const DistanceKernels kernels = supported_distance_kernels().back();
+
+    return kernels;
+}
+
+}
+
+double squared_distance(const double* x, const double* y, int d)
+{
+    /*!
+     * @brief Returns the squared Euclidean distance between two points, which
+     * is enough whenever distances are only compared
+     *
+     * @param x The \p d coordinates of the first point
+     * @param y The \p d coordinates of the second point
+     * @param d The dimension of the points
+     *
+     * @return The squared distance between \p x and \p y
+     *
+     */
+
+    return selected_kernels().one_to_one(x, y, d);
+}
+
+void squared_distances(const double* x, const double* rows, int count, int d, double* out)
+{
+    /*!
+     * @brief Computes the squared Euclidean distances from one point to a block
+     * of points stored contiguously, such as the rows of a PointSet
+     *
+     * @param x The \p d coordinates of the point
+     * @param rows The row-major coordinates of the \p count other points
+     * @param count The number of other points
+     * @param d The dimension of the points
+     * @param out The \p count squared distances, out[i] being the one to the i-th row
+     *
+     */
+
+    selected_kernels().one_to_many(x, rows, count, d, out);
+}
+
+const char* distance_kernel_name()
+{
+    /*!
+     * @brief Returns the name of the kernels selected for this processor,
+     * among "avx512", "avx2" and "scalar"
+     *
+     */
+
+    return selected_kernels().name;
+}
+
+std::vector<DistanceKernels> supported_distance_kernels()
+{
+    /*!
+     * @brief Lists the kernels the running processor can execute, from the
+     * scalar ones to the widest ones
+     *
+     */
+
+    std::vector<DistanceKernels> supported = {{squared_distance_any_scalar, squared_distances_any_scalar, "scalar"}};
+
+#ifdef DISTANCE_X86_KERNELS
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        supported.push_back({squared_distance_any_avx2, squared_distances_any_avx2, "avx2"});
+    }
+
+    if (__builtin_cpu_supports("avx512f")) {
+        supported.push_back({squared_distance_any_avx512, squared_distances_any_avx512, "avx512"});
+    }
+#endif
+
+    return supported;
+}
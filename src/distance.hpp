@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+struct DistanceKernels
+{
+    double (*one_to_one)(const double*, const double*, int);
+    void (*one_to_many)(const double*, const double*, int, int, double*);
+    const char* name;
+};
+
+double squared_distance(const double* x, const double* y, int d);
+void squared_distances(const double* x, const double* rows, int count, int d, double* out);
+const char* distance_kernel_name();
+std::vector<DistanceKernels> supported_distance_kernels();
@@ -19,6 +19,7 @@ Edge::Edge(Node* p1, Node* p2){
     this->p1 = p1;
     this->p2 = p2;
     this->weight = p1->dist(p2);
+    this->id = -1;
 }
 
 Edge::Edge(Node* p1, Node* p2, edge_weight_t weight){
@@ -36,6 +37,7 @@ Edge::Edge(Node* p1, Node* p2, edge_weight_t weight){
     this->p1 = p1;
     this->p2 = p2;
     this->weight = weight;
+    this->id = -1;
 }
 
 Node* Edge::other_node(Node* p){
@@ -19,7 +19,7 @@ class Edge{
         Node* p2;
         edge_weight_t weight;
 
-        node_id_t id;
+        edge_id_t id; // in the first graph the edge is added to, -1 before
 
         Edge(Node* p1, Node* p2, edge_weight_t weight);
         Edge(Node* p1, Node* p2);
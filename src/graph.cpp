@@ -1,10 +1,95 @@
 #include "graph.hpp"
+#include "pairwise.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 Graph::Graph(){
-    this->node_counter = 0;
-    this->edge_counter = 0;
+    this->frozen = false;
+}
+
+
+edge_weight_t ashiip_edge_weight(node_label_t label1, node_label_t label2)
+{
+    /*!
+     * @brief Draws the random weight of the edge between two labelled nodes, 
+     * following an exponential distribution. The draw only depends on the pair 
+     * of labels, so that any part of a file gives the same weights.
+     * 
+     * @param label1 The label of a node
+     * @param label2 The label of the other node
+     * 
+     * @return The weight of the edge
+     * 
+     */
+
+    uint64_t low = std::min(label1, label2);
+    uint64_t high = std::max(label1, label2);
+
+    // splitmix64 hash of the pair
+    uint64_t h = (high << 32) ^ low;
+    h += 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h = h ^ (h >> 31);
+
+    // uniform draw in [0, 1), then inverse of the exponential distribution
+    double u = (h >> 11) * (1.0 / 9007199254740992.0);
+    return -std::log1p(-u);
 }
 
+bool parse_ashiip_row(const std::string& line, node_label_t& label, std::vector<node_label_t>& neighbors)
+{
+    /*!
+     * @brief Parses a row of an aSHIIP file, which looks like "5 (2)  [1, 2, 4, 6]"
+     * 
+     * @param line The row
+     * @param label The label of the node of the row
+     * @param neighbors The labels of its neighbors
+     * 
+     * @return false if the line does not describe a node (header lines)
+     * 
+     */
+
+    std::istringstream iss(line);
+
+    // node's label (here, we want positive integers)
+    label = 0;
+    iss >> label;
+
+    if (label <= 0) {
+        return false;
+    }
+
+    // type of node (not useful here)
+    std::string cat;
+    iss >> cat;
+
+    // edges
+    neighbors.clear();
+    std::string other_node;
+    int j = 0;
+    while (iss >> other_node) {
+
+        if (j == 0) {
+            other_node = other_node.substr(1); // eliminating bracket
+        }
+
+        int length = other_node.size();
+        other_node = other_node.substr(0, length-1); // eliminating comma
+        neighbors.push_back(stoi(other_node));
+
+        j += 1;
+    }
+
+    return true;
+}
 
 void build_from_ashiip(Graph* g, std::string file_path)
 {
@@ -18,25 +103,18 @@ void build_from_ashiip(Graph* g, std::string file_path)
      */
 
     std::ifstream is(file_path);
-    assert(("No such file", is.is_open()));
+    assert(is.is_open() && "No such file");
 
     std::unordered_map<node_label_t, Node*> created_nodes;
     std::unordered_map<Node*, std::unordered_set<Node*> > links;
 
-    std::default_random_engine generator;
-    std::exponential_distribution<double> distribution(1);
-
     std::string line;
+    node_label_t label;
+    std::vector<node_label_t> neighbors;
 
     while (std::getline(is, line)) {
 
-        std::istringstream iss(line);
-
-        // node's label (here, we want positive integers)
-        node_label_t label;
-        iss >> label;
-
-        if (label <= 0) {
+        if (!parse_ashiip_row(line, label, neighbors)) {
             continue;
         }
 
@@ -48,22 +126,7 @@ void build_from_ashiip(Graph* g, std::string file_path)
             n_in = created_nodes.at(label);
         }
 
-        // type of node (not useful here)
-        std::string cat;
-        iss >> cat;
-
-        // edges
-        std::string other_node;
-        int j = 0;
-        while (iss >> other_node) {
-
-            if (j == 0) {
-                other_node = other_node.substr(1); // eliminating bracket
-            }
-
-            int length = other_node.size();
-            other_node = other_node.substr(0, length-1); // eliminating comma
-            node_label_t other_label = stoi(other_node);
+        for (node_label_t other_label : neighbors) {
 
             Node* n_out;
             if (created_nodes.find(other_label) == created_nodes.end()) {
@@ -91,13 +154,198 @@ void build_from_ashiip(Graph* g, std::string file_path)
             }
 
             if (force_insert == true) {
-                Edge* e = new Edge(n_in, n_out, distribution(generator));
+                Edge* e = new Edge(n_in, n_out, ashiip_edge_weight(label, other_label));
                 g->add_edge(e);
             }
+        }
+    }
+}
+
+bool is_binary_graph(std::string file_path)
+{
+    /*!
+     * @brief Checks whether a file starts like a binary graph file
+     * 
+     * @param file_path The path to the file
+     * 
+     */
+
+    std::ifstream is(file_path, std::ios::binary);
+
+    char magic[sizeof(BINARY_GRAPH_MAGIC)-1];
+    if (!is.read(magic, sizeof(magic))) {
+        return false;
+    }
+
+    return std::memcmp(magic, BINARY_GRAPH_MAGIC, sizeof(magic)) == 0;
+}
 
-            j += 1;
+void write_binary_graph(Graph* g, std::string file_path)
+{
+    /*!
+     * @brief Writes a graph in the binary format: a header, then the CSR 
+     * offsets, the weights, the labels of the nodes and the targets. Each 
+     * edge is stored once, in the row of its first endpoint.
+     * 
+     * @param g The graph
+     * @param file_path The path to the file
+     * 
+     */
+
+    const CSRGraph& csr = g->get_csr();
+
+    BinaryGraphHeader header;
+    std::memcpy(header.magic, BINARY_GRAPH_MAGIC, sizeof(header.magic));
+    header.version = BINARY_GRAPH_VERSION;
+    header.reserved = 0;
+    header.n = csr.n;
+    header.m = csr.m;
+
+    // grouping the edges by first endpoint, in order of identifiers within a row
+    std::vector<uint64_t> offsets(csr.n+1, 0);
+    for (const WeightedEdge& e : csr.edges) {
+        offsets[e.u+1] += 1;
+    }
+
+    for (int u = 0; u < csr.n; u ++) {
+        offsets[u+1] += offsets[u];
+    }
+
+    std::vector<double> weights(csr.m);
+    std::vector<uint32_t> targets(csr.m);
+    std::vector<uint64_t> next_slot(offsets.begin(), offsets.end()-1);
+
+    for (const WeightedEdge& e : csr.edges) {
+        uint64_t slot = next_slot[e.u]++;
+        weights[slot] = e.weight;
+        targets[slot] = e.v;
+    }
+
+    std::vector<int32_t> labels(csr.n);
+    for (int u = 0; u < csr.n; u ++) {
+        labels[u] = g->get_node(u)->label;
+    }
+
+    std::ofstream os(file_path, std::ios::binary);
+    assert(os.is_open() && "Cannot write file");
+
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    os.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    os.write(reinterpret_cast<const char*>(weights.data()), weights.size() * sizeof(double));
+    os.write(reinterpret_cast<const char*>(labels.data()), labels.size() * sizeof(int32_t));
+    os.write(reinterpret_cast<const char*>(targets.data()), targets.size() * sizeof(uint32_t));
+}
+
+void Graph::read_binary(std::string file_path)
+{
+    /*!
+     * @brief Builds the graph from a binary graph file, which is memory-mapped. 
+     * The CSR view is filled directly from the arrays of the file, each edge 
+     * being stored once there and symmetrised while the view is built. Nodes 
+     * are created with their labels, but edges only when they are requested.
+     * 
+     * @param file_path The path to the file 
+     * 
+     * @throw std::invalid_argument If the file cannot be read, or is not a 
+     * valid binary graph (header, length, offsets or targets)
+     * 
+     */
+
+    // the file is unmapped and closed however we leave
+    struct MappedFile
+    {
+        int fd = -1;
+        void* data = MAP_FAILED;
+        size_t size = 0;
+
+        ~MappedFile()
+        {
+            if (data != MAP_FAILED) {
+                munmap(data, size);
+            }
+            if (fd >= 0) {
+                close(fd);
+            }
         }
+    } file;
+
+    file.fd = open(file_path.c_str(), O_RDONLY);
+    if (file.fd < 0) {
+        throw std::invalid_argument("No such file: " + file_path);
+    }
+
+    struct stat st;
+    if (fstat(file.fd, &st) != 0) {
+        throw std::invalid_argument("Cannot read file: " + file_path);
+    }
+
+    file.size = st.st_size;
+    if (file.size < sizeof(BinaryGraphHeader)) {
+        throw std::invalid_argument("Truncated binary graph file");
+    }
+
+    file.data = mmap(NULL, file.size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+    if (file.data == MAP_FAILED) {
+        throw std::invalid_argument("Cannot map file: " + file_path);
+    }
+
+    const char* bytes = static_cast<const char*>(file.data);
+    const BinaryGraphHeader* header = reinterpret_cast<const BinaryGraphHeader*>(bytes);
+
+    if (std::memcmp(header->magic, BINARY_GRAPH_MAGIC, sizeof(header->magic)) != 0 || header->version != BINARY_GRAPH_VERSION) {
+        throw std::invalid_argument("Unsupported binary graph file");
     }
+
+    // identifiers are ints, which also keeps the sizes below from overflowing
+    uint64_t n = header->n;
+    uint64_t m = header->m;
+    if (n > (uint64_t) std::numeric_limits<node_id_t>::max() || m > (uint64_t) std::numeric_limits<edge_id_t>::max()) {
+        throw std::invalid_argument("Too large binary graph file");
+    }
+
+    uint64_t expected_size = sizeof(BinaryGraphHeader) + (n+1)*sizeof(uint64_t) + m*sizeof(double) + n*sizeof(int32_t) + m*sizeof(uint32_t);
+    if (file.size != expected_size) {
+        throw std::invalid_argument("Binary graph file of wrong length");
+    }
+
+    const uint64_t* offsets = reinterpret_cast<const uint64_t*>(bytes + sizeof(BinaryGraphHeader));
+    const double* weights = reinterpret_cast<const double*>(offsets + n+1);
+    const int32_t* labels = reinterpret_cast<const int32_t*>(weights + m);
+    const uint32_t* targets = reinterpret_cast<const uint32_t*>(labels + n);
+
+    if (offsets[0] != 0 || offsets[n] != m) {
+        throw std::invalid_argument("Corrupted binary graph file: bad offsets");
+    }
+
+    std::vector<WeightedEdge> flat_edges(m);
+    for (uint64_t u = 0; u < n; u ++) {
+        if (offsets[u+1] < offsets[u]) {
+            throw std::invalid_argument("Corrupted binary graph file: bad offsets");
+        }
+
+        for (uint64_t slot = offsets[u]; slot < offsets[u+1]; slot ++) {
+            if (targets[slot] >= n) {
+                throw std::invalid_argument("Corrupted binary graph file: bad target");
+            }
+
+            flat_edges[slot].weight = weights[slot];
+            flat_edges[slot].u = u;
+            flat_edges[slot].v = targets[slot];
+            flat_edges[slot].id = slot;
+        }
+    }
+
+    this->node_id_mapper.resize(n);
+    for (uint64_t u = 0; u < n; u ++) {
+        Node* node = new Node(labels[u]);
+        node->set_id(u);
+        this->node_id_mapper[u] = node;
+    }
+
+    this->edge_id_mapper.assign(m, NULL);
+
+    this->csr = CSRGraph(n, std::move(flat_edges));
+    this->frozen = true;
 }
 
 Graph::Graph(std::string file_path) : Graph()
@@ -105,13 +353,19 @@ Graph::Graph(std::string file_path) : Graph()
     /*!
      * @brief Builds a graph from scratch, with its nodes and edges contained in a file
      * 
-     * @param file_path The path to the file 
+     * @param file_path The path to the file, either generated by aSHIIP or in 
+     * the binary format
      * 
      */
-    build_from_ashiip(this, file_path);
+
+    if (is_binary_graph(file_path)) {
+        this->read_binary(file_path);
+    } else {
+        build_from_ashiip(this, file_path);
+    }
 }
 
-Graph::Graph(std::vector<Point*> points)
+Graph::Graph(std::vector<Point*> points) : Graph()
 {
     /*!
      * @brief Builds a graph from scratch, with its nodes being points of a certain dimension
@@ -121,18 +375,92 @@ Graph::Graph(std::vector<Point*> points)
      */
 
     int n = points.size();
+    int d = (n > 0) ? points[0]->get_dim() : 0;
     std::vector<Node*> nodes;
 
+    std::vector<double> coords((size_t) n * d);
+
     for (int i = 0; i < n; i ++) {
         nodes.push_back(new Node(i, points[i]));
         this->add_node(nodes[i]);
+
+        assert(points[i]->get_dim() == d && "Points must have the same dimension");
+        std::copy(points[i]->coords, points[i]->coords + d, coords.begin() + (size_t) i*d);
     }
 
-    for (int i = 0; i < n; i ++) {
-        for (int j = i+1; j < n; j ++) {
-            this->add_edge(new Edge(nodes[i], nodes[j]));
+    // distances are computed by tiles, which are gathered in a strip of whole 
+    // rows so that edges are still added row by row
+    std::vector<double> strip((size_t) PAIRWISE_TILE_SIZE * n);
+
+    pairwise_squared_distances(coords.data(), n, d, [&](int row_begin, int row_end, int col_begin, int col_end, const double* tile) {
+        for (int i = row_begin; i < row_end; i ++) {
+            const double* dist = tile + (size_t) (i - row_begin) * PAIRWISE_TILE_SIZE;
+            std::copy(dist, dist + (col_end - col_begin), strip.begin() + (size_t) (i - row_begin) * n + col_begin);
+        }
+
+        if (col_end < n) {
+            return;
         }
+
+        for (int i = row_begin; i < row_end; i ++) {
+            const double* dist = strip.data() + (size_t) (i - row_begin) * n;
+            for (int j = i+1; j < n; j ++) {
+                this->add_edge(new Edge(nodes[i], nodes[j], std::sqrt(dist[j])));
+            }
+        }
+    });
+}
+
+node_id_t Graph::local_id(Node* n)
+{
+    /*!
+     * @brief Returns the identifier of \p n in this graph. Nodes first added to 
+     * this graph carry it, the others are looked up among the foreign nodes
+     * 
+     * @param n The node
+     * 
+     * @return The identifier of \p n, or -1 if it is not in the graph
+     * 
+     */
+
+    node_id_t id = n->get_id();
+    if (id >= 0 && id < (node_id_t) this->node_id_mapper.size() && this->node_id_mapper[id] == n) {
+        return id;
     }
+
+    std::unordered_map<Node*, node_id_t>::iterator it = this->foreign_node_ids.find(n);
+    return (it != this->foreign_node_ids.end()) ? it->second : -1;
+}
+
+bool Graph::has_edge(Edge* e)
+{
+    /*!
+     * @brief Checks whether the edge \p e was added to this graph
+     * 
+     */
+
+    if (e->id >= 0 && e->id < (edge_id_t) this->edge_id_mapper.size() && this->edge_id_mapper[e->id] == e) {
+        return true;
+    }
+
+    return this->foreign_edges.find(e) != this->foreign_edges.end();
+}
+
+void Graph::thaw()
+{
+    /*!
+     * @brief Takes the flat edge list back from the CSR view, before the graph 
+     * is modified
+     * 
+     */
+
+    if (!this->frozen) {
+        return;
+    }
+
+    this->edges = std::move(this->csr.edges);
+    this->csr = CSRGraph();
+    this->frozen = false;
 }
 
 bool Graph::has_node(Node* n){
@@ -145,33 +473,33 @@ bool Graph::has_node(Node* n){
      * 
      */
 
-    return this->adjacency_lists.find(n) != this->adjacency_lists.end();
+    return this->local_id(n) >= 0;
 }
 
 void Graph::add_node(Node* n){
     /*!
-     * @brief Ajoute le noeud \p n au graphe
+     * @brief Ajoute le noeud \p n au graphe, avec le premier identifiant libre
      * 
      * @param n Le noeud
      * 
+     * @note Un noeud garde l'identifiant du premier graphe auquel il est ajouté ; 
+     * les autres graphes (eg. un MST) le rangent parmi leurs noeuds étrangers
+     * 
      */
 
-
     if(this->has_node(n))
         return;
 
-    this->adjacency_lists.insert(
-        std::pair<Node*, std::unordered_set<Edge*> >(
-                                                        n,
-                                                        std::unordered_set<Edge*>()
-                                                    )
-                                );
-    
-    n->set_id(this->node_counter);
-    this->node_id_mapper.insert(std::pair<node_id_t, Node*>(this->node_counter++, n));
-
-    
-    
+    this->thaw();
+
+    node_id_t id = this->node_id_mapper.size();
+    if (n->get_id() < 0) {
+        n->set_id(id);
+    } else {
+        this->foreign_node_ids.insert(std::pair<Node*, node_id_t>(n, id));
+    }
+
+    this->node_id_mapper.push_back(n);
 }
 
 
@@ -186,35 +514,53 @@ void Graph::add_edge(Edge* e){
      * 
      */
 
+    if(this->has_edge(e))
+        return;
+
     this->add_node(e->p1);
     this->add_node(e->p2);
+    this->thaw();
 
-    std::unordered_set<Edge*>& adj_p1 = this->adjacency_lists.at(e->p1);
-    adj_p1.insert(e);
-
-    std::unordered_set<Edge*>& adj_p2 = this->adjacency_lists.at(e->p2);
-    adj_p2.insert(e);
-
-    this->all_edges.insert(e);
+    edge_id_t id = this->edge_id_mapper.size();
+    if (e->id < 0) {
+        e->id = id;
+    } else {
+        this->foreign_edges.insert(e);
+    }
 
-    e->id = this->edge_counter;
-    this->edge_id_mapper.insert(std::pair<edge_id_t, Edge*>(this->edge_counter++, e));
+    this->edge_id_mapper.push_back(e);
 
+    WeightedEdge flat_edge;
+    flat_edge.weight = e->weight;
+    flat_edge.u = this->local_id(e->p1);
+    flat_edge.v = this->local_id(e->p2);
+    flat_edge.id = id;
+    this->edges.push_back(flat_edge);
 }
 
 
 
-const std::unordered_set<Edge*>& Graph::connected_edges(Node* n){
+std::vector<Edge*> Graph::connected_edges(Node* n){
     /*!
-     * @brief Liste les arrêtes entrantes/sortantes de \p n
+     * @brief Liste les arrêtes entrantes/sortantes de \p n, lues dans la vue CSR
      * 
      * @param n Le noeud dont on veut connaître les arrêtes liées
      * 
-     * @return Un ensemble en lecture seule des arrêtes liées à \p n
+     * @return Les arrêtes liées à \p n
      * 
      */
 
-    return this->adjacency_lists.at(n);
+    const CSRGraph& csr = this->get_csr();
+    node_id_t u = this->local_id(n);
+    assert(u >= 0 && "Node not in graph");
+
+    std::vector<Edge*> connected;
+    connected.reserve(csr.degree(u));
+    for (int slot = csr.offsets[u]; slot < csr.offsets[u+1]; slot ++) {
+        connected.push_back(this->get_edge(csr.edge_ids[slot]));
+    }
+
+    return connected;
 }
 
 int Graph::get_number_of_nodes() 
@@ -226,7 +572,7 @@ int Graph::get_number_of_nodes()
      * 
      */
 
-    return this->adjacency_lists.size();
+    return this->node_id_mapper.size();
 }
 
 std::vector<Node*> Graph::get_nodes()
@@ -234,16 +580,11 @@ std::vector<Node*> Graph::get_nodes()
     /*!
      * @brief Renvoie tous les noeuds du graphe (pointeurs)
      * 
-     * @return Un vecteur avec les noeuds du graphe
+     * @return Un vecteur avec les noeuds du graphe, rangés par identifiant
      * 
      */
 
-    std::vector<Node*> nodes;
-    for (auto kv : this->adjacency_lists) {
-        nodes.push_back(kv.first);
-    }
-
-    return nodes;
+    return this->node_id_mapper;
 }
 
 int Graph::get_number_of_edges()
@@ -255,7 +596,7 @@ int Graph::get_number_of_edges()
      * 
      */
 
-    return this->all_edges.size();
+    return this->edge_id_mapper.size();
 }
 
 std::unordered_set<Edge*> Graph::get_edges()
@@ -267,7 +608,11 @@ std::unordered_set<Edge*> Graph::get_edges()
      * 
      */
 
-    return this->all_edges;
+    std::unordered_set<Edge*> all_edges;
+    for (edge_id_t id = 0; id < (edge_id_t) this->edge_id_mapper.size(); id ++) {
+        all_edges.insert(this->get_edge(id));
+    }
+    return all_edges;
 }
 
 Node* Graph::get_any_node()
@@ -279,16 +624,25 @@ Node* Graph::get_any_node()
      * 
      */
 
-    std::vector<Node*> nodes = this->get_nodes();
+    return this->node_id_mapper[this->get_any_node_id()];
+}
+
+node_id_t Graph::get_any_node_id()
+{
+    /*!
+     * @brief Renvoie l'identifiant d'un sommet au hasard dans le graphe
+     * 
+     * @return L'identifiant d'un noeud au hasard
+     * 
+     */
+
     int n = this->get_number_of_nodes();
 
     std::random_device rd; 
     std::mt19937 gen(rd());
     std::uniform_int_distribution<> distrib(0, n-1);
 
-    int idx = distrib(gen);
-
-    return nodes[idx];
+    return distrib(gen);
 }
 
 double Graph::total_weight()
@@ -300,9 +654,11 @@ double Graph::total_weight()
      * 
      */
 
+    const std::vector<WeightedEdge>& flat_edges = this->frozen ? this->csr.edges : this->edges;
+
     double weight = 0.0;
-    for (Edge* e : this->all_edges) {
-        weight += e->weight;
+    for (const WeightedEdge& e : flat_edges) {
+        weight += e.weight;
     }
     return weight;
 }
@@ -326,8 +682,66 @@ Edge* Graph::get_edge(edge_id_t id){
      *
      * @param id The id of the edge
      * 
-     * @returns The edge matching \p id
+     * @returns The edge matching \p id, which is created on first request for 
+     * graphs read from a binary file
+     */
+
+    Edge*& e = this->edge_id_mapper.at(id);
+    if (e == NULL) {
+        const WeightedEdge& flat_edge = this->frozen ? this->csr.edges[id] : this->edges[id];
+        e = new Edge(this->node_id_mapper[flat_edge.u], this->node_id_mapper[flat_edge.v], flat_edge.weight);
+        e->id = id;
+    }
+
+    return e;
+}
+
+void Graph::freeze()
+{
+    /*!
+     * @brief Builds the CSR view of the graph from its current nodes and edges.
+     * Node and edge identifiers of the CSR view are the ones given by this graph.
+     * The flat edge list is moved into the view, so that a frozen graph only 
+     * holds its CSR arrays besides the node and edge pointers.
+     * 
+     * @note The view is invalidated as soon as a node or an edge is added
+     * 
+     */
+
+    if (this->frozen) {
+        return;
+    }
+
+    this->csr = CSRGraph(this->node_id_mapper.size(), std::move(this->edges));
+    this->edges = std::vector<WeightedEdge>();
+    this->frozen = true;
+}
+
+bool Graph::is_frozen()
+{
+    /*!
+     * @brief Checks whether the CSR view is up to date with the graph
+     * 
+     * @return true if the graph has not been modified since its last freeze
+     * 
      */
 
-    return this->edge_id_mapper.at(id);
-}
\ No newline at end of file
+    return this->frozen;
+}
+
+const CSRGraph& Graph::get_csr()
+{
+    /*!
+     * @brief Returns the CSR view of the graph, freezing it first if needed
+     * 
+     * @return A read-only reference to the CSR view, whose node (resp. edge) 
+     * identifiers match \ref Graph::get_node (resp. \ref Graph::get_edge)
+     * 
+     */
+
+    if (!this->frozen) {
+        this->freeze();
+    }
+
+    return this->csr;
+}
@@ -2,6 +2,7 @@
 
 #include "edge.hpp"
 #include "node.hpp"
+#include "csr_graph.hpp"
 
 #include <unordered_map>
 #include <unordered_set>
@@ -11,6 +12,28 @@
 #include <sstream>
 #include <cassert>
 #include <random>
+#include <cstdint>
+#include <algorithm>
+#include <cmath>
+
+#define BINARY_GRAPH_MAGIC "MSTGRAPH"
+#define BINARY_GRAPH_VERSION 1
+
+struct BinaryGraphHeader
+{
+    /*!
+     * @struct Header of a binary graph file, followed by the arrays
+     * offsets[n+1] (uint64), weights[m] (double), labels[n] (int32) and
+     * targets[m] (uint32), so that every array is aligned on its type
+     *
+     */
+
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t n;
+    uint64_t m;
+};
 
 class Graph{
 
@@ -20,14 +43,22 @@ class Graph{
      */
 
     private:
-        std::unordered_map<Node*, std::unordered_set<Edge*> > adjacency_lists;
-        std::unordered_set<Edge*> all_edges;
+        std::vector<Node*> node_id_mapper;
+        std::vector<Edge*> edge_id_mapper;
+
+        // nodes and edges identified by another graph (eg. those of a MST)
+        std::unordered_map<Node*, node_id_t> foreign_node_ids;
+        std::unordered_set<Edge*> foreign_edges;
+
+        std::vector<WeightedEdge> edges; // moved into the CSR view while frozen
+        CSRGraph csr;
+        bool frozen;
 
-        std::unordered_map<node_id_t, Node*> node_id_mapper;
-        std::unordered_map<edge_id_t, Edge*> edge_id_mapper;
+        void read_binary(std::string file_path);
 
-        node_id_t node_counter;
-        edge_id_t edge_counter;
+        node_id_t local_id(Node* n);
+        bool has_edge(Edge* e);
+        void thaw();
     
     public:
         Graph();
@@ -38,17 +69,27 @@ class Graph{
         void add_edge(Edge* e);
         bool has_node(Node* n);
 
-        const std::unordered_set<Edge*>& connected_edges(Node* n);
+        std::vector<Edge*> connected_edges(Node* n);
 
         int get_number_of_nodes();
         std::vector<Node*> get_nodes();
         int get_number_of_edges();
         std::unordered_set<Edge*> get_edges();
         Node* get_any_node();
+        node_id_t get_any_node_id();
 
         Node* get_node(node_id_t id);
         Edge* get_edge(edge_id_t id);
 
         double total_weight();
 
-};
\ No newline at end of file
+        void freeze();
+        bool is_frozen();
+        const CSRGraph& get_csr();
+
+};
+
+edge_weight_t ashiip_edge_weight(node_label_t label1, node_label_t label2);
+bool parse_ashiip_row(const std::string& line, node_label_t& label, std::vector<node_label_t>& neighbors);
+bool is_binary_graph(std::string file_path);
+void write_binary_graph(Graph* g, std::string file_path);
@@ -0,0 +1,279 @@
+#include "graph_partition.hpp"
+
+#include <mpi.h>
+
+GraphPartition::GraphPartition(std::string file_path, int rank_, int world_size_)
+{
+    /*!
+     * @brief Reads the part of an aSHIIP file belonging to processor \p rank_, 
+     * that is the rows starting in the bytes [size*rank/world_size, 
+     * size*(rank+1)/world_size) of the file
+     * 
+     * @param file_path The path to the file
+     * @param rank_ The rank of the processor (MPI-related)
+     * @param world_size_ The world size (MPI-related)
+     * 
+     */
+
+    this->rank = rank_;
+    this->world_size = world_size_;
+
+    std::ifstream is(file_path);
+    assert(is.is_open() && "No such file");
+
+    is.seekg(0, std::ios::end);
+    long long size = is.tellg();
+
+    long long block_begin = size * this->rank / this->world_size;
+    long long block_end = size * (this->rank+1) / this->world_size;
+
+    // skipping the row started in the previous block, unless it ends right before ours
+    std::string line;
+    if (block_begin > 0) {
+        is.seekg(block_begin-1);
+        std::getline(is, line);
+    } else {
+        is.seekg(0);
+    }
+
+    std::vector<node_label_t> row_labels;
+    std::vector<std::vector<node_label_t> > rows;
+
+    node_label_t label;
+    std::vector<node_label_t> neighbors;
+
+    while ((long long) is.tellg() < block_end && std::getline(is, line)) {
+        if (parse_ashiip_row(line, label, neighbors)) {
+            row_labels.push_back(label);
+            rows.push_back(neighbors);
+            this->owned_nodes.insert(this->get_or_create_node(label));
+        }
+    }
+
+    // an edge may be listed by both rows, or several times in a row, but is added once
+    std::unordered_set<uint64_t> links;
+
+    for (size_t i = 0; i < rows.size(); i ++) {
+        for (node_label_t other_label : rows[i]) {
+            this->add_link(links, row_labels[i], other_label);
+        }
+    }
+
+    this->exchange_links(links);
+
+    // owned nodes without any edge
+    for (Node* n : this->owned_nodes) {
+        this->graph.add_node(n);
+    }
+}
+
+void GraphPartition::add_link(std::unordered_set<uint64_t>& links, node_label_t label1, node_label_t label2)
+{
+    /*!
+     * @brief Adds the edge between the nodes labelled \p label1 and \p label2, 
+     * unless it is already in \p links
+     * 
+     */
+
+    uint64_t low = std::min(label1, label2);
+    uint64_t high = std::max(label1, label2);
+    if (!links.insert((high << 32) | low).second) {
+        return;
+    }
+
+    Node* n_in = this->get_or_create_node(label1);
+    Node* n_out = this->get_or_create_node(label2);
+    this->graph.add_edge(new Edge(n_in, n_out, ashiip_edge_weight(label1, label2)));
+}
+
+void GraphPartition::exchange_links(std::unordered_set<uint64_t>& links)
+{
+    /*!
+     * @brief Sends each edge listed by an owned row to the processor owning its 
+     * other endpoint, so that every processor holds all the edges of its nodes, 
+     * even those listed by a single row of the file. A node without any row of 
+     * its own, only listed as a neighbor, is owned by the processor given by its 
+     * label modulo the world size.
+     * 
+     * @param links The edges already held by this processor
+     * 
+     */
+
+    // owner of every node, from the labels read by each processor
+    std::vector<node_label_t> my_labels;
+    for (Node* n : this->owned_nodes) {
+        my_labels.push_back(n->label);
+    }
+
+    int n_mine = my_labels.size();
+    std::vector<int> n_labels(this->world_size);
+    MPI_Allgather(&n_mine, 1, MPI_INT, n_labels.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    std::vector<int> label_offsets(this->world_size+1, 0);
+    for (int r = 0; r < this->world_size; r ++) {
+        label_offsets[r+1] = label_offsets[r] + n_labels[r];
+    }
+
+    std::vector<node_label_t> all_labels(label_offsets[this->world_size]);
+    MPI_Allgatherv(my_labels.data(), n_mine, MPI_INT, all_labels.data(), n_labels.data(), label_offsets.data(), MPI_INT, MPI_COMM_WORLD);
+
+    std::unordered_map<node_label_t, int> owner;
+    for (int r = 0; r < this->world_size; r ++) {
+        for (int i = label_offsets[r]; i < label_offsets[r+1]; i ++) {
+            owner.insert(std::pair<node_label_t, int>(all_labels[i], r));
+        }
+    }
+
+    auto owner_of = [&](node_label_t label) {
+        std::unordered_map<node_label_t, int>::iterator it = owner.find(label);
+        return (it != owner.end()) ? it->second : (int) ((unsigned int) label % this->world_size);
+    };
+
+    // pairs (other endpoint, owned endpoint), grouped by destination
+    std::vector<std::vector<node_label_t> > outgoing(this->world_size);
+    std::vector<Node*> rowless_nodes;
+
+    for (Edge* e : this->graph.get_edges()) {
+        Node* mine = this->is_owned(e->p1) ? e->p1 : e->p2;
+        Node* other = e->other_node(mine);
+
+        int dest = owner_of(other->label);
+        if (dest != this->rank) {
+            outgoing[dest].push_back(other->label);
+            outgoing[dest].push_back(mine->label);
+        } else if (owner.find(other->label) == owner.end()) {
+            rowless_nodes.push_back(other);
+        }
+    }
+
+    for (Node* n : rowless_nodes) {
+        this->owned_nodes.insert(n);
+    }
+
+    std::vector<int> send_counts(this->world_size), send_offsets(this->world_size+1, 0);
+    for (int r = 0; r < this->world_size; r ++) {
+        send_counts[r] = outgoing[r].size();
+        send_offsets[r+1] = send_offsets[r] + send_counts[r];
+    }
+
+    std::vector<node_label_t> send_buffer(send_offsets[this->world_size]);
+    for (int r = 0; r < this->world_size; r ++) {
+        std::copy(outgoing[r].begin(), outgoing[r].end(), send_buffer.begin() + send_offsets[r]);
+        std::vector<node_label_t>().swap(outgoing[r]);
+    }
+
+    std::vector<int> recv_counts(this->world_size), recv_offsets(this->world_size+1, 0);
+    MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    for (int r = 0; r < this->world_size; r ++) {
+        recv_offsets[r+1] = recv_offsets[r] + recv_counts[r];
+    }
+
+    std::vector<node_label_t> recv_buffer(recv_offsets[this->world_size]);
+    MPI_Alltoallv(send_buffer.data(), send_counts.data(), send_offsets.data(), MPI_INT, 
+        recv_buffer.data(), recv_counts.data(), recv_offsets.data(), MPI_INT, MPI_COMM_WORLD);
+
+    for (size_t i = 0; i < recv_buffer.size(); i += 2) {
+        this->add_link(links, recv_buffer[i], recv_buffer[i+1]);
+        this->owned_nodes.insert(this->get_or_create_node(recv_buffer[i]));
+    }
+}
+
+Node* GraphPartition::get_or_create_node(node_label_t label)
+{
+    /*!
+     * @brief Returns the node with label \p label, creating it if needed
+     * 
+     */
+
+    std::unordered_map<node_label_t, Node*>::iterator it = this->nodes_by_label.find(label);
+    if (it != this->nodes_by_label.end()) {
+        return it->second;
+    }
+
+    Node* n = new Node(label);
+    this->nodes_by_label.insert(std::pair<node_label_t, Node*>(label, n));
+    return n;
+}
+
+Graph* GraphPartition::get_graph()
+{
+    /*!
+     * @brief Returns the graph of the rows read by this processor
+     * 
+     */
+
+    return &this->graph;
+}
+
+int GraphPartition::get_rank()
+{
+    return this->rank;
+}
+
+int GraphPartition::get_world_size()
+{
+    return this->world_size;
+}
+
+Node* GraphPartition::get_node(node_label_t label)
+{
+    /*!
+     * @brief Returns the node with label \p label
+     * 
+     * @param label The label of the node
+     * 
+     * @return The node, or NULL if neither it nor one of its neighbors is owned
+     * 
+     */
+
+    std::unordered_map<node_label_t, Node*>::iterator it = this->nodes_by_label.find(label);
+    if (it == this->nodes_by_label.end()) {
+        return NULL;
+    }
+
+    return it->second;
+}
+
+bool GraphPartition::is_owned(Node* n)
+{
+    /*!
+     * @brief Checks whether the row of \p n was read by this processor
+     * 
+     */
+
+    return this->owned_nodes.find(n) != this->owned_nodes.end();
+}
+
+std::vector<Node*> GraphPartition::get_owned_nodes()
+{
+    /*!
+     * @brief Returns the nodes owned by this processor, by increasing label
+     * 
+     */
+
+    std::vector<Node*> nodes(this->owned_nodes.begin(), this->owned_nodes.end());
+    std::sort(nodes.begin(), nodes.end(), [](Node* n1, Node* n2) { return n1->label < n2->label; });
+
+    return nodes;
+}
+
+std::vector<Edge*> GraphPartition::get_owned_edges()
+{
+    /*!
+     * @brief Returns the edges whose endpoint of smallest label is owned by this 
+     * processor, so that each edge is owned by a single processor
+     * 
+     */
+
+    std::vector<Edge*> edges;
+    for (Edge* e : this->graph.get_edges()) {
+        Node* low = (e->p1->label < e->p2->label) ? e->p1 : e->p2;
+        if (this->is_owned(low)) {
+            edges.push_back(e);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end(), [](Edge* e1, Edge* e2) { return e1->id < e2->id; });
+
+    return edges;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "graph.hpp"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <string>
+
+class GraphPartition
+{
+
+    /*!
+     * @class Part of a graph held by one processor. The rows of an aSHIIP file 
+     * are split by blocks of bytes, and each processor only reads the rows 
+     * starting in its block: it owns the nodes of these rows, and holds their 
+     * edges together with the other endpoints of these edges. A node listed only 
+     * as a neighbor is owned by the processor of rank its label modulo the 
+     * world size.
+     *
+     */
+
+    private:
+        Graph graph;
+        std::unordered_map<node_label_t, Node*> nodes_by_label;
+        std::unordered_set<Node*> owned_nodes;
+
+        int rank;
+        int world_size;
+
+        Node* get_or_create_node(node_label_t label);
+        void add_link(std::unordered_set<uint64_t>& links, node_label_t label1, node_label_t label2);
+        void exchange_links(std::unordered_set<uint64_t>& links);
+
+    public:
+        GraphPartition(std::string file_path, int rank_, int world_size_);
+
+        Graph* get_graph();
+        int get_rank();
+        int get_world_size();
+
+        Node* get_node(node_label_t label);
+        bool is_owned(Node* n);
+        std::vector<Node*> get_owned_nodes();
+        std::vector<Edge*> get_owned_edges();
+};
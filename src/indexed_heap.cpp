@@ -0,0 +1,241 @@
+#include "indexed_heap.hpp"
+
+IndexedHeap::IndexedHeap(int n)
+{
+    /*!
+     * @brief Builds an empty heap for the identifiers 0, ..., n-1
+     * 
+     * @param n Number of identifiers
+     * 
+     */
+
+    this->heap.reserve(n);
+    this->position.assign(n, -1);
+    this->keys.assign(n, 0.0);
+}
+
+bool IndexedHeap::less(int id1, int id2)
+{
+    /*!
+     * @brief Compares two identifiers by key, then by identifier for equal keys
+     * 
+     */
+
+    double k1 = this->keys[id1];
+    double k2 = this->keys[id2];
+
+    return k1 < k2 || (k1 == k2 && id1 < id2);
+}
+
+void IndexedHeap::sift_up(int i)
+{
+    /*!
+     * @brief Moves the identifier at index \p i up until its parent is smaller
+     * 
+     */
+
+    int id = this->heap[i];
+
+    while (i > 0) {
+        int parent = (i - 1) / HEAP_ARITY;
+        int parent_id = this->heap[parent];
+
+        if (!this->less(id, parent_id)) {
+            break;
+        }
+
+        this->heap[i] = parent_id;
+        this->position[parent_id] = i;
+        i = parent;
+    }
+
+    this->heap[i] = id;
+    this->position[id] = i;
+}
+
+void IndexedHeap::sift_down(int i)
+{
+    /*!
+     * @brief Moves the identifier at index \p i down until its children are larger
+     * 
+     */
+
+    int n = this->heap.size();
+    int id = this->heap[i];
+
+    while (true) {
+        int first_child = HEAP_ARITY*i + 1;
+        if (first_child >= n) {
+            break;
+        }
+
+        // finding the smallest child
+        int last_child = (first_child + HEAP_ARITY < n) ? first_child + HEAP_ARITY : n;
+        int best = first_child;
+        for (int c = first_child + 1; c < last_child; c ++) {
+            if (this->less(this->heap[c], this->heap[best])) {
+                best = c;
+            }
+        }
+
+        int best_id = this->heap[best];
+        if (!this->less(best_id, id)) {
+            break;
+        }
+
+        this->heap[i] = best_id;
+        this->position[best_id] = i;
+        i = best;
+    }
+
+    this->heap[i] = id;
+    this->position[id] = i;
+}
+
+bool IndexedHeap::empty()
+{
+    /*!
+     * @brief Checks whether the heap is empty
+     * 
+     * @return true if there is no identifier in the heap
+     * 
+     */
+
+    return this->heap.empty();
+}
+
+int IndexedHeap::size()
+{
+    /*!
+     * @brief Returns the number of identifiers in the heap
+     * 
+     * @return The size of the heap
+     * 
+     */
+
+    return this->heap.size();
+}
+
+bool IndexedHeap::contains(int id)
+{
+    /*!
+     * @brief Checks whether \p id is currently in the heap
+     * 
+     * @param id The identifier
+     * 
+     * @return true if \p id is in the heap
+     * 
+     */
+
+    return this->position[id] != -1;
+}
+
+double IndexedHeap::get_key(int id)
+{
+    /*!
+     * @brief Returns the key of \p id, which must be in the heap
+     * 
+     * @param id The identifier
+     * 
+     * @return The current key of \p id
+     * 
+     */
+
+    assert(this->contains(id) && "This identifier is not in the heap");
+
+    return this->keys[id];
+}
+
+int IndexedHeap::top()
+{
+    /*!
+     * @brief Returns the identifier with minimal key, the heap must not be empty
+     * 
+     * @return The identifier with minimal key
+     * 
+     */
+
+    assert(!this->empty() && "The heap is empty");
+
+    return this->heap[0];
+}
+
+void IndexedHeap::pop()
+{
+    /*!
+     * @brief Removes the identifier with minimal key, the heap must not be empty
+     * 
+     */
+
+    assert(!this->empty() && "The heap is empty");
+
+    int id = this->heap[0];
+    int last = this->heap.back();
+    this->heap.pop_back();
+    this->position[id] = -1;
+
+    if (!this->heap.empty()) {
+        this->heap[0] = last;
+        this->sift_down(0);
+    }
+}
+
+void IndexedHeap::push(int id, double key)
+{
+    /*!
+     * @brief Inserts \p id with key \p key, \p id must not be in the heap
+     * 
+     * @param id The identifier
+     * @param key Its key
+     * 
+     */
+
+    assert(!this->contains(id) && "This identifier is already in the heap");
+
+    this->keys[id] = key;
+    this->heap.push_back(id);
+    this->sift_up(this->heap.size() - 1);
+}
+
+void IndexedHeap::decrease_key(int id, double key)
+{
+    /*!
+     * @brief Lowers the key of \p id, which must be in the heap, to \p key
+     * 
+     * @param id The identifier
+     * @param key Its new key, not larger than the current one
+     * 
+     */
+
+    assert(this->contains(id) && "This identifier is not in the heap");
+    assert(key <= this->keys[id] && "The key can only decrease");
+
+    this->keys[id] = key;
+    this->sift_up(this->position[id]);
+}
+
+bool IndexedHeap::push_or_decrease(int id, double key)
+{
+    /*!
+     * @brief Inserts \p id if it is absent, otherwise lowers its key if 
+     * \p key is smaller than the current one
+     * 
+     * @param id The identifier
+     * @param key The candidate key
+     * 
+     * @return true if the heap has been modified
+     * 
+     */
+
+    if (!this->contains(id)) {
+        this->push(id, key);
+        return true;
+    }
+
+    if (key < this->keys[id]) {
+        this->decrease_key(id, key);
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <vector>
+#include <cassert>
+
+#define HEAP_ARITY 4
+
+class IndexedHeap
+{
+
+    /*!
+     * @class Indexed 4-ary min-heap over identifiers in [0, n), where each 
+     * identifier has at most one key, and which supports decrease-key
+     *
+     */
+
+    private:
+        std::vector<int> heap;      // identifiers, in heap order
+        std::vector<int> position;  // index of each identifier in heap, -1 if absent
+        std::vector<double> keys;   // key of each identifier
+
+        bool less(int id1, int id2);
+        void sift_up(int i);
+        void sift_down(int i);
+
+    public:
+        IndexedHeap(int n);
+
+        bool empty();
+        int size();
+        bool contains(int id);
+        double get_key(int id);
+
+        int top();
+        void pop();
+        void push(int id, double key);
+        void decrease_key(int id, double key);
+        bool push_or_decrease(int id, double key);
+};
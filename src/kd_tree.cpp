@@ -0,0 +1,209 @@
+#include "kd_tree.hpp"
+
+#include <algorithm>
+
+KDTree::KDTree(std::vector<Point*> points, int leaf_size_)
+{
+    /*!
+     * @brief Builds the k-d tree by recursively splitting the points at the 
+     * median of the dimension with the widest spread
+     * 
+     * @param points The points, which must share the same dimension
+     * @param leaf_size_ The maximal number of points in a leaf
+     * 
+     */
+
+    this->n = points.size();
+    this->d = (this->n > 0) ? points[0]->get_dim() : 0;
+    this->leaf_size = (leaf_size_ > 0) ? leaf_size_ : 1;
+
+    // the original coordinates are copied once, and permuted afterwards
+    this->coords.resize(this->n * this->d);
+    this->index.resize(this->n);
+    for (int i = 0; i < this->n; i ++) {
+        this->index[i] = i;
+        for (int j = 0; j < this->d; j ++) {
+            this->coords[i*this->d + j] = points[i]->coords[j];
+        }
+    }
+
+    if (this->n > 0) {
+        this->build(0, this->n);
+    }
+
+    std::vector<double> permuted(this->coords.size());
+    for (int i = 0; i < this->n; i ++) {
+        std::copy(this->coords.begin() + this->index[i]*this->d, 
+                  this->coords.begin() + (this->index[i]+1)*this->d, 
+                  permuted.begin() + i*this->d);
+    }
+    this->coords.swap(permuted);
+
+    this->lower.resize(this->nodes.size() * this->d);
+    this->upper.resize(this->nodes.size() * this->d);
+    for (unsigned int node = 0; node < this->nodes.size(); node ++) {
+        this->compute_bounding_box(node);
+    }
+}
+
+int KDTree::build(int begin, int end)
+{
+    /*!
+     * @brief Builds the subtree of the points index[begin, end)
+     * 
+     * @param begin First point of the subtree
+     * @param end Past-the-end point of the subtree
+     * 
+     * @return The position of the root of the subtree in nodes
+     * 
+     */
+
+    int node = this->nodes.size();
+    this->nodes.push_back(KDNode{begin, end, -1, -1});
+
+    if (end - begin <= this->leaf_size) {
+        return node;
+    }
+
+    // finding the dimension with the widest spread (coords is not permuted yet)
+    int split_dim = 0;
+    double widest = -1.0;
+    for (int j = 0; j < this->d; j ++) {
+        double lo = this->coords[this->index[begin]*this->d + j];
+        double hi = lo;
+        for (int i = begin+1; i < end; i ++) {
+            double x = this->coords[this->index[i]*this->d + j];
+            lo = std::min(lo, x);
+            hi = std::max(hi, x);
+        }
+
+        if (hi - lo > widest) {
+            widest = hi - lo;
+            split_dim = j;
+        }
+    }
+
+    int mid = begin + (end - begin)/2;
+    const std::vector<double>& coords = this->coords;
+    int d = this->d;
+
+    std::nth_element(this->index.begin() + begin, this->index.begin() + mid, this->index.begin() + end,
+        [&coords, d, split_dim](int i1, int i2) { return coords[i1*d + split_dim] < coords[i2*d + split_dim]; });
+
+    int left = this->build(begin, mid);
+    int right = this->build(mid, end);
+
+    this->nodes[node].left = left;
+    this->nodes[node].right = right;
+
+    return node;
+}
+
+void KDTree::compute_bounding_box(int node)
+{
+    /*!
+     * @brief Computes the bounding box of the points of \p node, once they 
+     * have been permuted in tree order
+     * 
+     */
+
+    int d = this->d;
+
+    const KDNode& kd_node = this->nodes[node];
+    for (int j = 0; j < d; j ++) {
+        double lo = this->coords[kd_node.begin*d + j];
+        double hi = lo;
+        for (int i = kd_node.begin+1; i < kd_node.end; i ++) {
+            double x = this->coords[i*d + j];
+            lo = std::min(lo, x);
+            hi = std::max(hi, x);
+        }
+
+        this->lower[node*d + j] = lo;
+        this->upper[node*d + j] = hi;
+    }
+}
+
+bool KDTree::is_leaf(int node) const
+{
+    /*!
+     * @brief Checks whether \p node has no children
+     * 
+     */
+
+    return this->nodes[node].left == -1;
+}
+
+const double* KDTree::get_coords(int i) const
+{
+    /*!
+     * @brief Returns the coordinates of the i-th point in tree order
+     * 
+     */
+
+    return this->coords.data() + i*this->d;
+}
+
+double KDTree::min_squared_distance(int node1, int node2) const
+{
+    /*!
+     * @brief Returns a lower bound of the squared distance between any point of 
+     * \p node1 and any point of \p node2, using their bounding boxes
+     * 
+     * @param node1 First node
+     * @param node2 Second node
+     * 
+     * @return The squared distance between the two bounding boxes
+     * 
+     */
+
+    int d = this->d;
+    const double* lo1 = this->lower.data() + node1*d;
+    const double* hi1 = this->upper.data() + node1*d;
+    const double* lo2 = this->lower.data() + node2*d;
+    const double* hi2 = this->upper.data() + node2*d;
+
+    double dist = 0.0;
+    for (int j = 0; j < d; j ++) {
+        double gap = 0.0;
+        if (hi1[j] < lo2[j]) {
+            gap = lo2[j] - hi1[j];
+        } else if (hi2[j] < lo1[j]) {
+            gap = lo1[j] - hi2[j];
+        }
+        dist += gap*gap;
+    }
+
+    return dist;
+}
+
+double KDTree::min_squared_distance(const double* x, int node) const
+{
+    /*!
+     * @brief Returns a lower bound of the squared distance between the point 
+     * \p x and any point of \p node, using its bounding box
+     * 
+     * @param x Coordinates of the point
+     * @param node The node
+     * 
+     * @return The squared distance between \p x and the bounding box
+     * 
+     */
+
+    int d = this->d;
+    const double* lo = this->lower.data() + node*d;
+    const double* hi = this->upper.data() + node*d;
+
+    double dist = 0.0;
+    for (int j = 0; j < d; j ++) {
+        double gap = 0.0;
+        if (x[j] < lo[j]) {
+            gap = lo[j] - x[j];
+        } else if (x[j] > hi[j]) {
+            gap = x[j] - hi[j];
+        }
+        dist += gap*gap;
+    }
+
+    return dist;
+}
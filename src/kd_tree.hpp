@@ -0,0 +1,51 @@
+#pragma once
+
+#include "point.hpp"
+
+#include <vector>
+
+struct KDNode
+{
+    /*!
+     * @struct Node of a k-d tree, which holds the points [begin, end) of the 
+     * permuted point array
+     *
+     */
+
+    int begin;
+    int end;
+    int left;   // -1 for leaves
+    int right;  // -1 for leaves
+};
+
+class KDTree
+{
+
+    /*!
+     * @class k-d tree over a set of points, where each node stores the bounding 
+     * box of its points. Points are copied contiguously in the tree order.
+     *
+     */
+
+    private:
+        int build(int begin, int end);
+        void compute_bounding_box(int node);
+
+    public:
+        int n;
+        int d;
+        int leaf_size;
+
+        std::vector<int> index;         // index[i] is the original position of the i-th point
+        std::vector<double> coords;     // coordinates in tree order, row-major
+        std::vector<KDNode> nodes;      // nodes[0] is the root
+        std::vector<double> lower;      // lower corner of each bounding box, row-major
+        std::vector<double> upper;      // upper corner of each bounding box, row-major
+
+        KDTree(std::vector<Point*> points, int leaf_size_ = 16);
+
+        bool is_leaf(int node) const;
+        const double* get_coords(int i) const;
+        double min_squared_distance(int node1, int node2) const;
+        double min_squared_distance(const double* x, int node) const;
+};
@@ -1,6 +1,8 @@
 #include "kmeans.hpp"
+#include "distance.hpp"
+#include "dimension.hpp"
 
-Cloud::Cloud(int _d, int _nmax, int _k)	
+Cloud::Cloud(int _d, int _nmax, int _k, int _num_threads)	
 {
     /*!
      * @brief Builds an empty cloud
@@ -8,17 +10,67 @@ Cloud::Cloud(int _d, int _nmax, int _k)
      * @param _d The dimension of the points
 	 * @param _nmax The maximal number of points in this cloud
 	 * @param _k The number of clusters to be drawn
+	 * @param _num_threads The number of threads, 0 meaning one per hardware core
      */
 
 	d = _d;
-	Point::d = _d;
 	n = 0;
 	k = _k;
 
 	nmax = _nmax;
 
-	points = new Point[nmax];
-	centers = new Point[k];
+	num_threads = resolve_num_threads(_num_threads);
+	pool = NULL;
+
+	point_set = new PointSet(nmax, d);
+	owns_point_set = true;
+	center_set = new PointSet(k, d);
+
+	points.reserve(nmax);
+	for (int i = 0; i < nmax; i ++) {
+		points.emplace_back(point_set->row(i), d);
+	}
+
+	centers.reserve(k);
+	for (int j = 0; j < k; j ++) {
+		centers.emplace_back(center_set->row(j), d);
+	}
+}
+
+Cloud::Cloud(PointSet *_point_set, int _k, int _num_threads)
+{
+    /*!
+     * @brief Builds a cloud over all the points of a set, without copying
+	 * their coordinates. Points are labelled in turn with each cluster.
+     * 
+     * @param _point_set The points, which must outlive the cloud
+	 * @param _k The number of clusters to be drawn
+	 * @param _num_threads The number of threads, 0 meaning one per hardware core
+     */
+
+	d = _point_set->get_dim();
+	n = _point_set->size();
+	k = _k;
+
+	nmax = n;
+
+	num_threads = resolve_num_threads(_num_threads);
+	pool = NULL;
+
+	point_set = _point_set;
+	owns_point_set = false;
+	center_set = new PointSet(k, d);
+
+	points.reserve(n);
+	for (int i = 0; i < n; i ++) {
+		points.emplace_back(point_set->row(i), d);
+		points[i].label = i % k;
+	}
+
+	centers.reserve(k);
+	for (int j = 0; j < k; j ++) {
+		centers.emplace_back(center_set->row(j), d);
+	}
 }
 
 Cloud::~Cloud()
@@ -27,8 +79,35 @@ Cloud::~Cloud()
      * @brief Destructor of the cloud class
      */
 
-	delete[] centers;
-	delete[] points;
+	delete center_set;
+	if (owns_point_set) {
+		delete point_set;
+	}
+	delete pool;
+}
+
+int Cloud::get_num_blocks()
+{
+    /*!
+     * @brief Number of blocks the points are split in, so that each thread 
+	 * gets at least KMEANS_POINTS_PER_BLOCK points
+     */
+
+	int numBlocks = (this->n + KMEANS_POINTS_PER_BLOCK - 1) / KMEANS_POINTS_PER_BLOCK;
+	return std::max(1, std::min(this->num_threads, numBlocks));
+}
+
+ThreadPool &Cloud::get_pool()
+{
+    /*!
+     * @brief Threads of this cloud, started on first use and kept until the 
+	 * cloud is destroyed
+     */
+
+	if (pool == NULL) {
+		pool = new ThreadPool(num_threads);
+	}
+	return *pool;
 }
 
 void Cloud::add_point(Point &p, int label)
@@ -40,8 +119,8 @@ void Cloud::add_point(Point &p, int label)
 	 * @param label A label to give to this point
      */
 
-	assert(("Too much points!", n < nmax));
-	assert(("No center to assign to this point!", label<k));
+	assert(n < nmax && "Too much points!");
+	assert(label<k && "No center to assign to this point!");
 
 	for(int m = 0; m < d; m++)
 	{
@@ -150,28 +229,41 @@ int Cloud::set_voronoi_labels()
      * @brief E-step in the kmeans algorithm
      */
 
-	int changedLabels = 0;
+	int numBlocks = get_num_blocks();
+	blockDists.resize((size_t) numBlocks * k);
+	blockChanges.resize(numBlocks);
 
-	for (int i = 0; i < this->n; i ++){
-		int pointLabel = points[i].label;
-		int newLabel = points[i].label;
-		double minDist = points[i].distance(&(centers[pointLabel]));
+	run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
 
-		for (int j = 0; j < this->k; j ++){
-			double dist = points[i].distance(&(centers[j]));
-			if (dist < minDist || (dist == minDist && j < newLabel)) {
-				minDist = dist;
-				newLabel = j;
+		// squared distances to all the centers, which are contiguous in center_set
+		double* dists = blockDists.data() + (size_t) block * k;
+		int changedLabels = 0;
+
+		for (int i = begin; i < end; i ++){
+			squared_distances(points[i].coords, center_set->row(0), this->k, this->d, dists);
+
+			int pointLabel = points[i].label;
+			int newLabel = points[i].label;
+			double minDist = dists[pointLabel];
+
+			for (int j = 0; j < this->k; j ++){
+				double dist = dists[j];
+				if (dist < minDist || (dist == minDist && j < newLabel)) {
+					minDist = dist;
+					newLabel = j;
+				}
 			}
-		}
 
-		if (newLabel != pointLabel){
-			points[i].label = newLabel;
-			changedLabels += 1;
+			if (newLabel != pointLabel){
+				points[i].label = newLabel;
+				changedLabels += 1;
+			}
 		}
-	}
+
+		blockChanges[block] = changedLabels;
+	});
 	
-	return changedLabels;
+	return std::accumulate(blockChanges.begin(), blockChanges.end(), 0);
 }
 
 void Cloud::set_centroid_centers()
@@ -180,62 +272,562 @@ void Cloud::set_centroid_centers()
      * @brief M-step in the kmeans algorithm
      */
 
-	int* clusterSizes = new int [this->k] ();
+	dispatch_dimension(this->d, [&](auto D) { this->set_centroid_centers_fixed<decltype(D)::value>(); });
+}
 
-	// we start with "new" points
-	Point *newCenters = new Point [this->k] ();
+template <int D>
+void Cloud::set_centroid_centers_fixed()
+{
+    /*!
+     * @brief M-step in the kmeans algorithm, for points of dimension D, or of 
+	 * any dimension when D = 0
+     */
 
-	// we count the number of data points in each cluster 
-	// and accumulate their sum
-	for (int i = 0; i < this->n; i ++){
+	const int dim = (D > 0) ? D : this->d;
+	const size_t centersSize = (size_t) k * dim;
 
-		int pointLabel = points[i].label;
-		clusterSizes[pointLabel] += 1;
+	int numBlocks = get_num_blocks();
+	blockSums.resize(numBlocks * centersSize);
+	blockCounts.resize((size_t) numBlocks * k);
 
-		for (int j = 0; j < this->d; j ++){
-			newCenters[pointLabel].coords[j] += points[i].coords[j];
+	// each block counts the data points of each cluster 
+	// and accumulates their sum
+	run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
+		double* sums = blockSums.data() + block * centersSize;
+		int* clusterSizes = blockCounts.data() + (size_t) block * k;
+
+		std::fill(sums, sums + centersSize, 0.0);
+		std::fill(clusterSizes, clusterSizes + this->k, 0);
+
+		for (int i = begin; i < end; i ++){
+
+			int pointLabel = points[i].label;
+			clusterSizes[pointLabel] += 1;
+
+			double* sum = sums + (size_t) pointLabel * dim;
+			const double* x = point_set->row(i);
+			for (int j = 0; j < dim; j ++){
+				sum[j] += x[j];
+			}
 		}
+	});
+
+	// the blocks are added pairwise, the first one ending with the total
+	for (int step = 1; step < numBlocks; step *= 2){
+		int numPairs = (numBlocks - step + 2 * step - 1) / (2 * step);
+
+		run_blocks(std::min(numBlocks, numPairs), numPairs, [&](int, int begin, int end) {
+			for (int pair = begin; pair < end; pair ++){
+				int block = 2 * step * pair;
+
+				double* sums = blockSums.data() + block * centersSize;
+				const double* otherSums = sums + step * centersSize;
+				for (size_t j = 0; j < centersSize; j ++){
+					sums[j] += otherSums[j];
+				}
+
+				int* clusterSizes = blockCounts.data() + (size_t) block * k;
+				const int* otherSizes = clusterSizes + (size_t) step * k;
+				for (int j = 0; j < this->k; j ++){
+					clusterSizes[j] += otherSizes[j];
+				}
+			}
+		});
 	}
 
-	// we compute the average per cluster
+	// we compute the average per cluster, empty ones keeping their center
 	for (int i = 0; i < this->k; i ++){
-		if (clusterSizes[i] > 0){
-			for (int j = 0; j < this->d; j ++){
-				newCenters[i].coords[j] /= clusterSizes[i];
+		if (blockCounts[i] > 0){
+			const double* sum = blockSums.data() + (size_t) i * dim;
+			double* center = center_set->row(i);
+			for (int j = 0; j < dim; j ++){
+				center[j] = sum[j] / blockCounts[i];
 			}
-			
-			this->set_center(newCenters[i], i);
 		}
 	}
-
-	delete[] clusterSizes;
-	clusterSizes = NULL;
-	delete[] newCenters;
-	newCenters = NULL;
 }
 
-void Cloud::kmeans()
+void Cloud::kmeans(KMeansMode mode, KMeansInit init)
 {
 	/*!
      * @brief Computes the kmeans algorithm on this cloud. It is possible 
 	 * to select different initializations for the centers, within bounding 
-	 * box, forgy, plusplus and random partition. 
+	 * box, forgy, plusplus, parallel and random partition. 
+     * 
+     * @param mode Whether each iteration computes the distances from every 
+	 * point to every center (Lloyd), or skips those which the triangle 
+	 * inequality proves useless, with Hamerly's or Elkan's bounds, which 
+	 * give the same clustering up to ties between distances. The mini-batch 
+	 * mode only approximates it, but each step costs a batch of points.
+	 * @param init How the centers are initialized
      */
 
 	std::cout << "\nComputing clustering using kmeans...";
 
-	// init_bounding_box();
-	init_forgy(); 
-	// init_plusplus(); 
-	// init_random_partition();
+	if (init == KMeansInit::BoundingBox) {
+		init_bounding_box();
+	} else if (init == KMeansInit::PlusPlus) {
+		init_plusplus();
+	} else if (init == KMeansInit::Parallel) {
+		init_parallel();
+	} else if (init == KMeansInit::RandomPartition) {
+		init_random_partition();
+	} else {
+		init_forgy();
+	}
+
+	if (mode == KMeansMode::MiniBatch) {
+		kmeans_mini_batch();
+	} else if (mode == KMeansMode::Elkan) {
+		kmeans_elkan();
+	} else if (mode == KMeansMode::Hamerly) {
+		kmeans_hamerly();
+	} else {
+		kmeans_lloyd();
+	}
+	
+	std::cout << "[OK]" << std::endl;
+}
+
+void Cloud::kmeans_lloyd()
+{
+	/*!
+     * @brief Lloyd's heuristics, which alternates E and M-steps until no 
+	 * label changes
+     */
 
-	// running Lloyd's heuristics
 	int changesMade = 0;
 	do {
 		changesMade = set_voronoi_labels();
 		set_centroid_centers();
 	} while (changesMade > 0);
-	
+}
+
+void Cloud::set_center_movements(const PointSet &oldCenters, std::vector<double> &movements)
+{
+	/*!
+     * @brief Computes how far each center moved during the last M-step
+     * 
+     * @param oldCenters The centers before the M-step
+	 * @param movements The k distances between old and new centers
+     */
+
+	for (int j = 0; j < this->k; j ++){
+		movements[j] = std::sqrt(squared_distance(oldCenters.row(j), center_set->row(j), this->d));
+	}
+}
+
+void Cloud::set_center_distances(std::vector<double> &centerDists, std::vector<double> &halfSeparations)
+{
+	/*!
+     * @brief Computes the distances between centers. A point closer to its 
+	 * center than half the distance to another center cannot be closer to 
+	 * the latter.
+     * 
+     * @param centerDists The k*k distances between centers
+	 * @param halfSeparations For each center, half the distance to the 
+	 * nearest other center
+     */
+
+	for (int j = 0; j < this->k; j ++){
+		double* dists = centerDists.data() + (size_t) j * k;
+		squared_distances(center_set->row(j), center_set->row(0), this->k, this->d, dists);
+
+		halfSeparations[j] = DBL_MAX;
+		for (int l = 0; l < this->k; l ++){
+			dists[l] = std::sqrt(dists[l]);
+			if (l != j && 0.5 * dists[l] < halfSeparations[j]){
+				halfSeparations[j] = 0.5 * dists[l];
+			}
+		}
+	}
+}
+
+void Cloud::kmeans_hamerly()
+{
+	/*!
+     * @brief Lloyd's heuristics accelerated with Hamerly's bounds: each 
+	 * point keeps an upper bound on the distance to its center and a lower 
+	 * bound on the distance to any other center, and distances to all the 
+	 * centers are only computed when the bounds do not rule out a change
+     */
+
+	std::vector<double> upper(this->n);
+	std::vector<double> lower(this->n);
+	std::vector<double> movements(this->k);
+	std::vector<double> centerDists((size_t) k * k);
+	std::vector<double> halfSeparations(this->k);
+
+	PointSet oldCenters(this->k, this->d);
+	size_t centersSize = (size_t) k * d;
+
+	int numBlocks = get_num_blocks();
+	blockDists.resize((size_t) numBlocks * k);
+	blockChanges.resize(numBlocks);
+
+	// exact E-step for one point, which also resets its bounds
+	auto assign = [&](int i, double* dists) {
+		squared_distances(points[i].coords, center_set->row(0), this->k, this->d, dists);
+
+		int pointLabel = points[i].label;
+		int newLabel = pointLabel;
+		double minDist = dists[pointLabel];
+		for (int j = 0; j < this->k; j ++){
+			if (dists[j] < minDist || (dists[j] == minDist && j < newLabel)) {
+				minDist = dists[j];
+				newLabel = j;
+			}
+		}
+
+		double secondDist = DBL_MAX;
+		for (int j = 0; j < this->k; j ++){
+			if (j != newLabel && dists[j] < secondDist){
+				secondDist = dists[j];
+			}
+		}
+
+		upper[i] = std::sqrt(minDist);
+		lower[i] = std::sqrt(secondDist);
+
+		points[i].label = newLabel;
+		return (int) (newLabel != pointLabel);
+	};
+
+	run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
+		double* dists = blockDists.data() + (size_t) block * k;
+		int changedLabels = 0;
+
+		for (int i = begin; i < end; i ++){
+			changedLabels += assign(i, dists);
+		}
+
+		blockChanges[block] = changedLabels;
+	});
+	int changesMade = std::accumulate(blockChanges.begin(), blockChanges.end(), 0);
+
+	while (true) {
+		std::copy(center_set->get_data(), center_set->get_data() + centersSize, oldCenters.get_data());
+		set_centroid_centers();
+
+		if (changesMade == 0) {
+			break;
+		}
+
+		set_center_movements(oldCenters, movements);
+		set_center_distances(centerDists, halfSeparations);
+
+		// the lower bound of a point decreases by the largest movement 
+		// among the centers other than its own
+		int fastest = 0;
+		for (int j = 1; j < this->k; j ++){
+			if (movements[j] > movements[fastest]){
+				fastest = j;
+			}
+		}
+		double secondMovement = 0.0;
+		for (int j = 0; j < this->k; j ++){
+			if (j != fastest && movements[j] > secondMovement){
+				secondMovement = movements[j];
+			}
+		}
+
+		run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
+			double* dists = blockDists.data() + (size_t) block * k;
+			int changedLabels = 0;
+
+			for (int i = begin; i < end; i ++){
+				int pointLabel = points[i].label;
+
+				upper[i] += movements[pointLabel];
+				lower[i] -= (pointLabel == fastest) ? secondMovement : movements[fastest];
+
+				double bound = std::max(halfSeparations[pointLabel], lower[i]);
+				if (upper[i] < bound){
+					continue;
+				}
+
+				// the upper bound may just be loose
+				upper[i] = std::sqrt(squared_distance(points[i].coords, center_set->row(pointLabel), this->d));
+				if (upper[i] < bound){
+					continue;
+				}
+
+				changedLabels += assign(i, dists);
+			}
+
+			blockChanges[block] = changedLabels;
+		});
+		changesMade = std::accumulate(blockChanges.begin(), blockChanges.end(), 0);
+	}
+}
+
+void Cloud::kmeans_elkan()
+{
+	/*!
+     * @brief Lloyd's heuristics accelerated with Elkan's bounds: each point 
+	 * keeps an upper bound on the distance to its center and a lower bound 
+	 * on the distance to every center, so that only the distances to the 
+	 * centers which may be closer are computed. It needs n*k bounds, but 
+	 * skips more distances than Hamerly's when k is large.
+     */
+
+	std::vector<double> upper(this->n);
+	std::vector<double> lower((size_t) n * k);
+	std::vector<double> movements(this->k);
+	std::vector<double> centerDists((size_t) k * k);
+	std::vector<double> halfSeparations(this->k);
+
+	PointSet oldCenters(this->k, this->d);
+	size_t centersSize = (size_t) k * d;
+
+	int numBlocks = get_num_blocks();
+	blockChanges.resize(numBlocks);
+
+	// the first E-step computes every distance
+	run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
+		int changedLabels = 0;
+
+		for (int i = begin; i < end; i ++){
+			double* lowerBounds = lower.data() + (size_t) i * k;
+			squared_distances(points[i].coords, center_set->row(0), this->k, this->d, lowerBounds);
+
+			int pointLabel = points[i].label;
+			for (int j = 0; j < this->k; j ++){
+				lowerBounds[j] = std::sqrt(lowerBounds[j]);
+			}
+
+			int newLabel = pointLabel;
+			for (int j = 0; j < this->k; j ++){
+				if (lowerBounds[j] < lowerBounds[newLabel] || (lowerBounds[j] == lowerBounds[newLabel] && j < newLabel)) {
+					newLabel = j;
+				}
+			}
+
+			upper[i] = lowerBounds[newLabel];
+			if (newLabel != pointLabel){
+				points[i].label = newLabel;
+				changedLabels += 1;
+			}
+		}
+
+		blockChanges[block] = changedLabels;
+	});
+	int changesMade = std::accumulate(blockChanges.begin(), blockChanges.end(), 0);
+
+	while (true) {
+		std::copy(center_set->get_data(), center_set->get_data() + centersSize, oldCenters.get_data());
+		set_centroid_centers();
+
+		if (changesMade == 0) {
+			break;
+		}
+
+		set_center_movements(oldCenters, movements);
+		set_center_distances(centerDists, halfSeparations);
+
+		run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
+			int changedLabels = 0;
+
+			for (int i = begin; i < end; i ++){
+				double* lowerBounds = lower.data() + (size_t) i * k;
+				int pointLabel = points[i].label;
+
+				upper[i] += movements[pointLabel];
+				for (int j = 0; j < this->k; j ++){
+					lowerBounds[j] = std::max(0.0, lowerBounds[j] - movements[j]);
+				}
+
+				if (upper[i] < halfSeparations[pointLabel]){
+					continue;
+				}
+
+				int newLabel = pointLabel;
+				bool tight = false;
+
+				for (int j = 0; j < this->k; j ++){
+					if (j == newLabel){
+						continue;
+					}
+
+					double bound = std::max(lowerBounds[j], 0.5 * centerDists[(size_t) newLabel * k + j]);
+					if (upper[i] < bound){
+						continue;
+					}
+
+					// the upper bound may just be loose
+					if (!tight){
+						upper[i] = std::sqrt(squared_distance(points[i].coords, center_set->row(newLabel), this->d));
+						lowerBounds[newLabel] = upper[i];
+						tight = true;
+
+						if (upper[i] < bound){
+							continue;
+						}
+					}
+
+					double dist = std::sqrt(squared_distance(points[i].coords, center_set->row(j), this->d));
+					lowerBounds[j] = dist;
+
+					if (dist < upper[i] || (dist == upper[i] && j < newLabel)){
+						newLabel = j;
+						upper[i] = dist;
+					}
+				}
+
+				if (newLabel != pointLabel){
+					points[i].label = newLabel;
+					changedLabels += 1;
+				}
+			}
+
+			blockChanges[block] = changedLabels;
+		});
+		changesMade = std::accumulate(blockChanges.begin(), blockChanges.end(), 0);
+	}
+}
+
+bool Cloud::run_mini_batches(int numBatches, std::vector<int> &centerCounts, double tolerance, double &averageMovement)
+{
+	/*!
+     * @brief Mini-batch kmeans steps over the points currently in the cloud. 
+	 * Each batch is sampled uniformly, assigned to the centers, which then 
+	 * move towards their points with a learning rate of one over the number 
+	 * of points they have received so far.
+     * 
+     * @param numBatches The maximal number of batches
+	 * @param centerCounts The number of points received by each center, 
+	 * updated in place
+	 * @param tolerance The movement of centers under which the centers are 
+	 * considered stable
+	 * @param averageMovement A moving average of the largest center movement 
+	 * per batch, negative before the first batch, updated in place
+     * 
+     * @return Whether the average movement went under the tolerance
+     */
+
+	int batchSize = std::min(KMEANS_BATCH_SIZE, this->n);
+	double smoothing = std::min(1.0, 2.0 * batchSize / (this->n + 1));
+
+	std::vector<int> batch(batchSize);
+	std::vector<int> batchLabels(batchSize);
+	std::vector<double> dists(this->k);
+
+	PointSet oldCenters(this->k, this->d);
+	size_t centersSize = (size_t) k * d;
+
+	for (int b = 0; b < numBatches; b ++){
+
+		// the whole batch is assigned to the centers before they move
+		for (int l = 0; l < batchSize; l ++){
+			batch[l] = rand() % this->n;
+			squared_distances(point_set->row(batch[l]), center_set->row(0), this->k, this->d, dists.data());
+			batchLabels[l] = std::min_element(dists.begin(), dists.end()) - dists.begin();
+		}
+
+		std::copy(center_set->get_data(), center_set->get_data() + centersSize, oldCenters.get_data());
+
+		for (int l = 0; l < batchSize; l ++){
+			int label = batchLabels[l];
+			centerCounts[label] += 1;
+
+			double learningRate = 1.0 / centerCounts[label];
+			double* center = center_set->row(label);
+			const double* x = point_set->row(batch[l]);
+			for (int j = 0; j < this->d; j ++){
+				center[j] += learningRate * (x[j] - center[j]);
+			}
+		}
+
+		double movement = 0.0;
+		for (int j = 0; j < this->k; j ++){
+			movement = std::max(movement, squared_distance(oldCenters.row(j), center_set->row(j), this->d));
+		}
+		movement = std::sqrt(movement);
+
+		if (averageMovement < 0){
+			averageMovement = movement;
+		} else {
+			averageMovement = (1 - smoothing) * averageMovement + smoothing * movement;
+		}
+
+		if (averageMovement < tolerance){
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Cloud::kmeans_mini_batch()
+{
+	/*!
+     * @brief Mini-batch kmeans over all the points of the cloud, followed by 
+	 * one E-step to label them
+     */
+
+	std::vector<int> centerCounts(this->k, 0);
+	double averageMovement = -1.0;
+
+	run_mini_batches(KMEANS_MAX_BATCHES, centerCounts, KMEANS_TOLERANCE, averageMovement);
+
+	set_voronoi_labels();
+}
+
+void Cloud::kmeans_stream(PointStream &stream, int maxPasses, double tolerance)
+{
+	/*!
+     * @brief Computes mini-batch kmeans over the points of a stream, which 
+	 * are read in chunks of at most nmax points into this cloud, so that 
+	 * memory stays bounded whatever the size of the file. Centers are 
+	 * initialized from the first chunk, then each chunk is sampled as many 
+	 * times as it holds batches, until the centers are stable or after 
+	 * \p maxPasses passes over the stream. The cloud ends up holding the 
+	 * first chunk, labelled.
+     * 
+     * @param stream The points to cluster, of the dimension of the cloud
+	 * @param maxPasses The maximal number of passes over the stream
+	 * @param tolerance The movement of centers under which they are 
+	 * considered stable
+     */
+
+	assert(stream.get_dim() == this->d && "Unexpected dimension");
+
+	std::cout << "\nComputing clustering using streaming kmeans...";
+
+	stream.rewind();
+	this->n = stream.read_chunk(point_set->get_data(), this->nmax);
+	assert(this->n >= this->k && "Not enough points to draw the centers");
+
+	init_forgy();
+
+	std::vector<int> centerCounts(this->k, 0);
+	double averageMovement = -1.0;
+	bool converged = false;
+
+	for (int pass = 0; pass < maxPasses && !converged; pass ++){
+		if (pass > 0){
+			stream.rewind();
+			this->n = stream.read_chunk(point_set->get_data(), this->nmax);
+		}
+
+		while (this->n > 0 && !converged){
+			int numBatches = std::max(1, this->n / KMEANS_BATCH_SIZE);
+			converged = run_mini_batches(numBatches, centerCounts, tolerance, averageMovement);
+
+			if (!converged){
+				this->n = stream.read_chunk(point_set->get_data(), this->nmax);
+			}
+		}
+	}
+
+	stream.rewind();
+	this->n = stream.read_chunk(point_set->get_data(), this->nmax);
+
+	for (int i = 0; i < this->n; i ++){
+		points[i].label = 0;
+	}
+	set_voronoi_labels();
+
 	std::cout << "[OK]" << std::endl;
 }
 
@@ -264,7 +856,7 @@ void Cloud::init_bounding_box()
 		}
 	}
 
-	Point center;
+	Point center(this->d);
 	for (int i = 0; i < this->k; i ++){
 		center.label = i;
 
@@ -312,7 +904,7 @@ void Cloud::init_forgy()
 	}
 
 	// we just have to build our centers now!
-	Point c;
+	Point c(this->d);
 	for (int i = 0; i < this->k; i ++){
 		c.label = i;
 
@@ -329,73 +921,246 @@ void Cloud::init_forgy()
 	chosenPoints = NULL;
 }
 
+double Cloud::update_min_distances(const double *newCenters, int numNewCenters, int firstIndex, std::vector<double> &minDists, std::vector<int> &nearest, std::vector<double> &dists, std::vector<double> &blockTotals)
+{
+	/*!
+     * @brief Lowers the squared distance from each point to its nearest 
+	 * center, given new centers. Each block of points is compared with all 
+	 * the new centers while it is in cache.
+     * 
+     * @param newCenters The row-major coordinates of the new centers
+	 * @param numNewCenters The number of new centers
+	 * @param firstIndex The index of the first new center
+	 * @param minDists The n squared distances to the nearest center, 
+	 * updated in place
+	 * @param nearest The n indices of the nearest center, updated in place
+	 * @param dists Scratch space for n distances
+	 * @param blockTotals The sum of \p minDists over each block of points
+     * 
+     * @return The sum of \p minDists
+     */
+
+	int numBlocks = blockTotals.size();
+
+	run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
+		if (begin == end){
+			blockTotals[block] = 0.0;
+			return;
+		}
+
+		for (int c = 0; c < numNewCenters; c ++){
+			squared_distances(newCenters + (size_t) c * d, point_set->row(begin), end - begin, this->d, dists.data() + begin);
+
+			for (int i = begin; i < end; i ++){
+				if (dists[i] < minDists[i]){
+					minDists[i] = dists[i];
+					nearest[i] = firstIndex + c;
+				}
+			}
+		}
+
+		double total = 0.0;
+		for (int i = begin; i < end; i ++){
+			total += minDists[i];
+		}
+
+		blockTotals[block] = total;
+	});
+
+	return std::accumulate(blockTotals.begin(), blockTotals.end(), 0.0);
+}
+
+int Cloud::sample_min_distances(const std::vector<double> &minDists, const std::vector<double> &blockTotals, double total)
+{
+	/*!
+     * @brief Draws a point with probability proportional to its squared 
+	 * distance to the nearest center
+     * 
+     * @param minDists The n squared distances to the nearest center
+	 * @param blockTotals The sum of \p minDists over each block of points
+	 * @param total The sum of \p minDists
+     * 
+     * @return The index of the drawn point
+     */
+
+	if (total <= 0){
+		return rand() % this->n;
+	}
+
+	double randomValue = (double)rand() / RAND_MAX * total;
+
+	// the block of the point first, then the point within the block
+	int numBlocks = blockTotals.size();
+	int block = 0;
+	while (block < numBlocks - 1 && randomValue >= blockTotals[block]){
+		randomValue -= blockTotals[block];
+		block += 1;
+	}
+
+	int begin = (long long) this->n * block / numBlocks;
+	int end = (long long) this->n * (block+1) / numBlocks;
+	for (int i = begin; i < end; i ++){
+		if (randomValue < minDists[i]){
+			return i;
+		}
+		randomValue -= minDists[i];
+	}
+
+	// rounding errors may leave us past the end, where we take the last 
+	// point which can be drawn
+	int last = this->n - 1;
+	while (last > 0 && minDists[last] <= 0){
+		last -= 1;
+	}
+	return last;
+}
+
 void Cloud::init_plusplus()
 {
     /*!
      * @brief Initializes the centers of this cloud using kmeans++
-	 * which consists in drawing a distribution of points
+	 * which consists in drawing a distribution of points. Each new center 
+	 * is drawn with probability proportional to the squared distance to 
+	 * the nearest center already chosen, which is kept for every point and 
+	 * only compared with the newest center.
      */
 
-	// step of initialization for kmeans++
-	int* chosenPoints = new int [this->k] ();
+	int numBlocks = get_num_blocks();
+
+	std::vector<double> minDists(this->n, DBL_MAX);
+	std::vector<int> nearest(this->n, 0);
+	std::vector<double> dists(this->n);
+	std::vector<double> blockTotals(numBlocks);
+
 	int randomPoint = rand() % this->n;
-	chosenPoints[0] = randomPoint;
+	this->set_center(points[randomPoint], 0);
 
-	// loop 
-	double* distances = new double [this->n] ();
 	for (int i = 1; i < this->k; i ++){
+		double totalDist = update_min_distances(center_set->row(i-1), 1, i-1, minDists, nearest, dists, blockTotals);
 
-		// we compute the nearest center for each data point
-		double totalDist = 0.0;
+		int chosenPoint = sample_min_distances(minDists, blockTotals, totalDist);
+		this->set_center(points[chosenPoint], i);
+	}
+}
 
-		for (int j = 0; j < this->n; j ++){
-			distances[j] = DBL_MAX;
+void Cloud::init_parallel()
+{
+    /*!
+     * @brief Initializes the centers of this cloud using kmeans||, which 
+	 * draws many candidates in a few rounds rather than one per pass over 
+	 * the points: at each round, every point is drawn independently with 
+	 * probability proportional to its squared distance to the nearest 
+	 * candidate, about KMEANS_OVERSAMPLING * k of them per round. The 
+	 * candidates, weighted by the number of points they are the nearest 
+	 * of, are then reduced to k centers with kmeans++.
+     */
+
+	int numBlocks = get_num_blocks();
+
+	std::vector<double> minDists(this->n, DBL_MAX);
+	std::vector<int> nearest(this->n, 0);
+	std::vector<double> dists(this->n);
+	std::vector<double> blockTotals(numBlocks);
+
+	// row-major coordinates of the candidates
+	std::vector<double> candidates;
+
+	int randomPoint = rand() % this->n;
+	candidates.insert(candidates.end(), points[randomPoint].coords, points[randomPoint].coords + this->d);
+	double totalDist = update_min_distances(candidates.data(), 1, 0, minDists, nearest, dists, blockTotals);
+
+	// each block draws its points with its own generator, seeded in turn
+	std::vector<unsigned int> blockSeeds(numBlocks);
+	std::vector<std::vector<int>> blockDraws(numBlocks);
+	double oversampling = (double) KMEANS_OVERSAMPLING * this->k;
 
-			for (int l = 0; l < i; l ++){
-				double dist = points[j].distance(&(points[chosenPoints[l]]));
+	for (int round = 0; round < KMEANS_PARALLEL_ROUNDS && totalDist > 0; round ++){
+		for (int block = 0; block < numBlocks; block ++){
+			blockSeeds[block] = rand();
+		}
 
-				if (dist < distances[j]){
-					distances[j] = dist;
+		run_blocks(numBlocks, this->n, [&](int block, int begin, int end) {
+			std::mt19937 generator(blockSeeds[block]);
+			std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+			blockDraws[block].clear();
+			for (int i = begin; i < end; i ++){
+				if (uniform(generator) * totalDist < oversampling * minDists[i]){
+					blockDraws[block].push_back(i);
 				}
+			}
+		});
 
-				totalDist += distances[j];
+		int numCandidates = candidates.size() / this->d;
+		for (int block = 0; block < numBlocks; block ++){
+			for (int i : blockDraws[block]){
+				candidates.insert(candidates.end(), points[i].coords, points[i].coords + this->d);
 			}
 		}
 
-		for (int j = 0; j < this->n; j ++){
-			distances[j] /= totalDist; 
-			if (j > 0){
-				distances[j] += distances[j-1]; // we create a cumulative sum
-			}
+		int numNewCandidates = candidates.size() / this->d - numCandidates;
+		if (numNewCandidates > 0){
+			totalDist = update_min_distances(candidates.data() + (size_t) numCandidates * d, numNewCandidates, numCandidates, minDists, nearest, dists, blockTotals);
 		}
+	}
 
-		// we find the next center from a uniform distribution
-		double randomUnif = (double)rand() / RAND_MAX;
+	int numCandidates = candidates.size() / this->d;
+	Point c(this->d);
 
-		for (int j = 0; j < this->n; j ++){
-			if ( (j == 0 && distances[j] > randomUnif && randomUnif >= 0) \
-					|| (j > 0 && distances[j] > randomUnif && randomUnif >= distances[j-1]) ){
-				chosenPoints[i] = j;
-			}
+	// few candidates: all are centers, the others are drawn as in kmeans++
+	if (numCandidates <= this->k){
+		for (int i = 0; i < numCandidates; i ++){
+			std::copy(candidates.data() + (size_t) i * d, candidates.data() + (size_t) (i+1) * d, c.coords);
+			this->set_center(c, i);
 		}
+
+		for (int i = numCandidates; i < this->k; i ++){
+			int chosenPoint = sample_min_distances(minDists, blockTotals, totalDist);
+			this->set_center(points[chosenPoint], i);
+			totalDist = update_min_distances(center_set->row(i), 1, i, minDists, nearest, dists, blockTotals);
+		}
+
+		return;
 	}
 
-	// we just have to build our centers now!
-	Point c;
+	// weight of each candidate, that is the number of points it is the nearest of
+	std::vector<double> weights(numCandidates, 0.0);
+	for (int i = 0; i < this->n; i ++){
+		weights[nearest[i]] += 1;
+	}
+
+	// weighted kmeans++ over the candidates, which are few
+	std::vector<double> candidateMinDists(numCandidates, DBL_MAX);
+	std::vector<double> candidateDists(numCandidates);
+	std::vector<double> candidateWeights(weights);
+
 	for (int i = 0; i < this->k; i ++){
-		c.label = i;
+		double totalWeight = std::accumulate(candidateWeights.begin(), candidateWeights.end(), 0.0);
 
-		for (int j = 0; j < this->d; j ++){
-			c.coords[j] = points[chosenPoints[i]].coords[j];
+		int chosen = rand() % numCandidates;
+		if (totalWeight > 0){
+			double randomValue = (double)rand() / RAND_MAX * totalWeight;
+
+			chosen = 0;
+			while (chosen < numCandidates - 1 && randomValue >= candidateWeights[chosen]){
+				randomValue -= candidateWeights[chosen];
+				chosen += 1;
+			}
+			while (chosen > 0 && candidateWeights[chosen] <= 0){
+				chosen -= 1;
+			}
 		}
 
+		const double* center = candidates.data() + (size_t) chosen * d;
+		std::copy(center, center + this->d, c.coords);
 		this->set_center(c, i);
-	}		
 
-	delete[] chosenPoints;
-	chosenPoints = NULL;
-	delete[] distances;
-	distances = NULL;
+		squared_distances(center, candidates.data(), numCandidates, this->d, candidateDists.data());
+		for (int j = 0; j < numCandidates; j ++){
+			candidateMinDists[j] = std::min(candidateMinDists[j], candidateDists[j]);
+			candidateWeights[j] = weights[j] * candidateMinDists[j];
+		}
+	}
 }
 
 void Cloud::init_random_partition()
@@ -424,57 +1189,29 @@ double Cloud::silhouette()
      * @return The silhouette of this cloud
      */
 
-	double silhouette = 0.0;
-
-	// we compute a and b which are respectively the 
-	// average distance to points of the same cluster 
-	// and min of average distances to foreign clusters
-	double* a = new double [n] ();
-	double* b = new double [n] ();
-	double* s = new double [n] ();
-
+	std::vector<int> labels(this->n);
 	for (int i = 0; i < this->n; i ++){
-		double* distPointClusters = new double [k] ();
-		int* clustersSize = new int [k] ();
-		
-		for (int j = 0; j < this->n; j ++){
-			if (j != i){
-				int pointLabel = points[j].label;
-				clustersSize[pointLabel] += 1;
-
-				distPointClusters[pointLabel] += std::sqrt(points[i].distance(&(points[j])));
-			}
-		}
-
-		double minDist = DBL_MAX;
-		for (int j = 0; j < this->k; j ++){
-			if (clustersSize[j] > 0){
-				distPointClusters[j] /= clustersSize[j];
-
-				if (j != points[i].label && distPointClusters[j] < minDist) {
-					minDist = distPointClusters[j];
-				}
-			}
-		}
-
-		a[i] = distPointClusters[points[i].label];
-		b[i] = 0.0;
-		if (minDist < DBL_MAX){
-			b[i] = minDist;
-		}
+		labels[i] = points[i].label;
+	}
 
-		delete[] distPointClusters;
-		distPointClusters = NULL;
-		delete[] clustersSize;
-		clustersSize = NULL;
+	return silhouette_score(point_set->get_data(), labels.data(), this->n, this->d, this->k, get_pool());
+}
 
-		s[i] = (b[i] - a[i]) / (std::max(a[i], b[i]));
-	}
+SilhouetteEstimate Cloud::sampled_silhouette(int sampleSize)
+{
+    /*!
+     * @brief Estimates the silhouette of this cloud from a stratified sample 
+	 * of its points
+     * 
+     * @param sampleSize The approximate number of points to sample
+     * 
+     * @return The estimated silhouette, with its 95% confidence interval
+     */
 
+	std::vector<int> labels(this->n);
 	for (int i = 0; i < this->n; i ++){
-		silhouette += s[i];
+		labels[i] = points[i].label;
 	}
-	silhouette /= this->n;
 
-	return silhouette;
-}
+	return sampled_silhouette_score(point_set->get_data(), labels.data(), this->n, this->d, this->k, sampleSize, get_pool());
+}
\ No newline at end of file
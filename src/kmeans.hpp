@@ -11,8 +11,50 @@
 #include <string>
 #include <algorithm>	// for count
 #include <vector>
+#include <functional>	// for ref
+#include <numeric>	// for accumulate
+#include <random>	// for mt19937
 
 #include "point.hpp"
+#include "point_set.hpp"
+#include "point_stream.hpp"
+#include "thread_pool.hpp"
+#include "silhouette.hpp"
+
+// mini-batch kmeans: points per batch, batches of the in-memory mode, passes 
+// over the file of the streaming mode, and tolerance on the center movements
+#define KMEANS_BATCH_SIZE 1024
+#define KMEANS_MAX_BATCHES 1000
+#define KMEANS_MAX_PASSES 10
+#define KMEANS_TOLERANCE 1e-4
+
+// streaming kmeans: default number of points held in memory at once
+#define KMEANS_STREAM_CHUNK 65536
+
+// minimal number of points handled by each thread
+#define KMEANS_POINTS_PER_BLOCK 4096
+
+// kmeans||: rounds of sampling, and expected number of centers drawn per 
+// round, as a multiple of k
+#define KMEANS_PARALLEL_ROUNDS 5
+#define KMEANS_OVERSAMPLING 2
+
+enum class KMeansMode
+{
+	Lloyd,		// distances from every point to every center at each iteration
+	Hamerly,	// one upper and one lower bound per point
+	Elkan,		// one upper bound and one lower bound per center for each point
+	MiniBatch	// updates the centers from random batches of points
+};
+
+enum class KMeansInit
+{
+	BoundingBox,		// uniformly in the bounding box of the points
+	Forgy,				// distinct points drawn uniformly
+	PlusPlus,			// kmeans++, points drawn one by one with D^2 weighting
+	Parallel,			// kmeans||, a few rounds of oversampling, then kmeans++
+	RandomPartition		// centroids of a random labelling
+};
 
 class Cloud 
 {
@@ -24,13 +66,48 @@ private:
 	// maximum possible number of Points
 	int nmax;
 
-	Point *points;
-	Point *centers;
+	// coordinates are stored in point sets, which the points and centers view
+	PointSet *point_set;
+	bool owns_point_set;
+	PointSet *center_set;
+
+	std::vector<Point> points;
+	std::vector<Point> centers;
+
+	// points are split in blocks, one per thread, each with its own scratch 
+	// space, which is kept from one iteration to the next
+	int num_threads;
+	ThreadPool *pool;
+	std::vector<double> blockDists;
+	std::vector<int> blockChanges;
+	std::vector<double> blockSums;
+	std::vector<int> blockCounts;
+
+	int get_num_blocks();
+	ThreadPool &get_pool();
+	template <typename Function> void run_blocks(int numBlocks, int count, Function f);
+
+	template <int D> void set_centroid_centers_fixed();
+
+	void kmeans_lloyd();
+	void kmeans_hamerly();
+	void kmeans_elkan();
+	void kmeans_mini_batch();
+	bool run_mini_batches(int numBatches, std::vector<int> &centerCounts, double tolerance, double &averageMovement);
+	void set_center_movements(const PointSet &oldCenters, std::vector<double> &movements);
+	void set_center_distances(std::vector<double> &centerDists, std::vector<double> &halfSeparations);
+
+	double update_min_distances(const double *newCenters, int numNewCenters, int firstIndex, std::vector<double> &minDists, std::vector<int> &nearest, std::vector<double> &dists, std::vector<double> &blockTotals);
+	int sample_min_distances(const std::vector<double> &minDists, const std::vector<double> &blockTotals, double total);
 
 public:
-    Cloud(int _d, int _nmax, int _k);
+    Cloud(int _d, int _nmax, int _k, int _num_threads = 0);
+    Cloud(PointSet *_point_set, int _k, int _num_threads = 0);
     ~Cloud();
 
+    Cloud(const Cloud&) = delete;
+    Cloud& operator=(const Cloud&) = delete;
+
     int get_d();
     int get_n();
     int get_k();
@@ -43,11 +120,36 @@ public:
     double intracluster_variance();
     int set_voronoi_labels();
     void set_centroid_centers();
-    void kmeans();
+    void kmeans(KMeansMode mode = KMeansMode::Lloyd, KMeansInit init = KMeansInit::Forgy);
+    void kmeans_stream(PointStream &stream, int maxPasses = KMEANS_MAX_PASSES, double tolerance = KMEANS_TOLERANCE);
     void init_bounding_box();
     void init_forgy();
     void init_plusplus();
+    void init_parallel();
     void init_random_partition();
 
     double silhouette();
-};
\ No newline at end of file
+    SilhouetteEstimate sampled_silhouette(int sampleSize);
+};
+
+template <typename Function>
+void Cloud::run_blocks(int numBlocks, int count, Function f)
+{
+	/*!
+     * @brief Splits [0, count) into \p numBlocks contiguous blocks, and calls 
+	 * f(block, begin, end) on each of them from the threads of the pool
+     */
+
+	if (numBlocks == 1) {
+		f(0, 0, count);
+		return;
+	}
+
+	// the pool gets a reference, so that no closure is allocated
+	auto task = [&](int, int begin, int end) {
+		for (int block = begin; block < end; block ++) {
+			f(block, (long long) count * block / numBlocks, (long long) count * (block+1) / numBlocks);
+		}
+	};
+	get_pool().run(numBlocks, std::ref(task));
+}
@@ -2,7 +2,9 @@
 #include "mst_prim.hpp"
 #include "mst_boruvka.hpp"
 #include "mst_kruskal.hpp"
+#include "mst_filter_kruskal.hpp"
 #include "mst_prim_kumar.hpp"
+#include "mst_distributed_boruvka.hpp"
 #include "compare_clustering.hpp"
 
 #include <mpi.h>
@@ -10,26 +12,105 @@
 #include <vector>
 #include <iostream>
 #include <sstream>
+#include <cstdlib>
+
+#include <sys/stat.h>
 
 void exit_with_help()
 {
     std::printf(
     "Usage: build/main [options]\n"
     "options:\n"
-    "-a : run Prim, Boruvka & Kruskal algorithms on generated graphs\n"
+    "-a : run Prim, Boruvka, Kruskal & Filter-Kruskal algorithms on generated graphs\n"
+    "-b : convert the generated graphs to the binary format, then used by -a and -i\n"
     "-c : run a comparison between MST clustering and k-means\n"
+    "-s n : with -c, estimate silhouettes from samples of n points rather than exactly\n"
+    "-k mode : with -c and -i, run kmeans as lloyd (default), hamerly, elkan or minibatch\n"
+    "-n init : with -c and -i, initialize kmeans with forgy (default), box, plusplus, parallel or partition\n"
     "-i : run a comparison between Inconsistency clustering and k-means\n"
-    "-m : run Prim with MPI\n"
+    "-f file : run streaming k-means on a file of points, read in chunks, as -c does on whole sets\n"
+    "-m : run Prim-Kumar (also with threads) & distributed Boruvka algorithms with MPI\n"
     );
 	exit(1);
 }
 
+std::string graph_file(std::string name)
+{
+    /*!
+     * @brief Returns the path of a generated graph, in the binary format if it 
+     * was converted after the text graph was last written, the text graph 
+     * being read otherwise, so that a regenerated graph is never shadowed by 
+     * a stale conversion
+     * 
+     * @param name The name of the graph, without extension
+     * 
+     */
+
+    std::string binary_path = "data/" + name + ".bin";
+    std::string text_path = "data/" + name + ".txt";
+
+    if (!is_binary_graph(binary_path)) {
+        return text_path;
+    }
+
+    struct stat binary_stat, text_stat;
+    if (stat(binary_path.c_str(), &binary_stat) == 0 && stat(text_path.c_str(), &text_stat) == 0
+        && binary_stat.st_mtime < text_stat.st_mtime) {
+        std::cout << binary_path << " is older than " << text_path << ", which is read instead (run -b to convert it again)" << std::endl;
+        return text_path;
+    }
+
+    return binary_path;
+}
+
+KMeansMode parse_kmeans_mode(std::string name)
+{
+    /*!
+     * @brief Returns the kmeans variant given on the command line, or exits
+     * with the help if it is unknown
+     * 
+     */
+
+    if (name == "lloyd") return KMeansMode::Lloyd;
+    if (name == "hamerly") return KMeansMode::Hamerly;
+    if (name == "elkan") return KMeansMode::Elkan;
+    if (name == "minibatch") return KMeansMode::MiniBatch;
+
+    std::fprintf(stderr, "unknown kmeans mode\n");
+    exit_with_help();
+    return KMeansMode::Lloyd;
+}
+
+KMeansInit parse_kmeans_init(std::string name)
+{
+    /*!
+     * @brief Returns the kmeans initialization given on the command line, or
+     * exits with the help if it is unknown
+     * 
+     */
+
+    if (name == "forgy") return KMeansInit::Forgy;
+    if (name == "box") return KMeansInit::BoundingBox;
+    if (name == "plusplus") return KMeansInit::PlusPlus;
+    if (name == "parallel") return KMeansInit::Parallel;
+    if (name == "partition") return KMeansInit::RandomPartition;
+
+    std::fprintf(stderr, "unknown kmeans initialization\n");
+    exit_with_help();
+    return KMeansInit::Forgy;
+}
+
 int main(int argc, char** argv){
 
     bool run_mst_algo = false;
     bool run_mst_clust = false;
     bool run_mst_inc = false;
     bool run_mpi_prim = false;
+    bool run_conversion = false;
+    int silhouette_sample = 0;
+    KMeansMode kmeans_mode = KMeansMode::Lloyd;
+    KMeansInit kmeans_init = KMeansInit::Forgy;
+    std::string stream_file;
 
     if (argc <= 1) 
     {
@@ -39,13 +120,29 @@ int main(int argc, char** argv){
 	for (int i = 1; i<argc; i++)
 	{
 		if(argv[i][0] != '-') exit_with_help();
-		++i;
-		switch(argv[i-1][1])
+		switch(argv[i][1])
 		{
 			case 'a': run_mst_algo = true; break;
 			case 'c': run_mst_clust = true; break;
 			case 'i': run_mst_inc = true; break;
             case 'm': run_mpi_prim = true; break;
+            case 'b': run_conversion = true; break;
+            case 's':
+                if (++i >= argc) exit_with_help();
+                silhouette_sample = std::atoi(argv[i]);
+                break;
+            case 'k':
+                if (++i >= argc) exit_with_help();
+                kmeans_mode = parse_kmeans_mode(argv[i]);
+                break;
+            case 'f':
+                if (++i >= argc) exit_with_help();
+                stream_file = argv[i];
+                break;
+            case 'n':
+                if (++i >= argc) exit_with_help();
+                kmeans_init = parse_kmeans_init(argv[i]);
+                break;
 			default:
 				std::fprintf(stderr,"unknown option\n");
 				exit_with_help();
@@ -56,6 +153,22 @@ int main(int argc, char** argv){
      * Tasks 
      */
 
+    if (run_conversion)
+    {
+        std::vector<std::string> graph_names({"ERn4p10", "ERn8p10", "ERn100p10", "ERn250p10", "ERn500p10", "ERn1000p10", 
+            "BAn100mo20m2", "BAn250mo20m2", "BAn500mo20m2", "BAn1000mo20m2"});
+
+        for (std::string name : graph_names)
+        {
+            std::cout << "Converting data/" << name << ".txt to the binary format...";
+
+            Graph g = Graph("data/" + name + ".txt");
+            write_binary_graph(&g, "data/" + name + ".bin");
+
+            std::cout << "[OK]" << std::endl;
+        }
+    }
+
     // TASKS 1 & 2
 
     if (run_mst_algo) 
@@ -66,7 +179,7 @@ int main(int argc, char** argv){
 
         for (int n : ER_graph_sizes) 
         {
-            Graph gER = Graph("data/ERn" + std::to_string(n) + "p10.txt");
+            Graph gER = Graph(graph_file("ERn" + std::to_string(n) + "p10"));
 
             std::cout << "\nComparing MST algorithms with Erdos-Rényi graphs of size " << n << "." << std::endl;
             std::cout << "The graph contains " << gER.get_number_of_edges() << " edges." << std::endl;
@@ -79,6 +192,9 @@ int main(int argc, char** argv){
 
             KruskalAlgorithm kruskalER = KruskalAlgorithm(&gER);
             kruskalER.compute_mst();
+
+            FilterKruskalAlgorithm filterKruskalER = FilterKruskalAlgorithm(&gER);
+            filterKruskalER.compute_mst();
         }
 
         // Comparing MST algorithms on Barabasi-Albert graphs
@@ -87,7 +203,7 @@ int main(int argc, char** argv){
 
         for (int n : BA_graph_sizes) 
         {
-            Graph gBA = Graph("data/BAn" + std::to_string(n) + "mo20m2.txt");
+            Graph gBA = Graph(graph_file("BAn" + std::to_string(n) + "mo20m2"));
 
             std::cout << "\nComparing MST algorithms with Barabasi-Albert graphs of size " << n << "." << std::endl;
             std::cout << "The graph contains " << gBA.get_number_of_edges() << " edges." << std::endl;
@@ -100,6 +216,9 @@ int main(int argc, char** argv){
 
             KruskalAlgorithm kruskalBA = KruskalAlgorithm(&gBA);
             kruskalBA.compute_mst();
+
+            FilterKruskalAlgorithm filterKruskalBA = FilterKruskalAlgorithm(&gBA);
+            filterKruskalBA.compute_mst();
         }
     }
 
@@ -117,19 +236,38 @@ int main(int argc, char** argv){
         int world_rank;
         MPI_Comm_rank(MPI_COMM_WORLD, &world_rank);
 
+        // threads of the hybrid mode, sharing the cores of a host between its processors
+        MPI_Comm host_comm;
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, world_rank, MPI_INFO_NULL, &host_comm);
+
+        int host_size;
+        MPI_Comm_size(host_comm, &host_size);
+        MPI_Comm_free(&host_comm);
+
+        int num_threads = std::max(1, resolve_num_threads(0) / host_size);
+
         
         
 
         for (int n : ER_graph_sizes) 
         {
-            Graph gER = Graph("data/ERn" + std::to_string(n) + "p10.txt");
+            GraphPartition gER = GraphPartition("data/ERn" + std::to_string(n) + "p10.txt", world_rank, world_size);
 
-            std::cout << "\nComparing MST algorithms with Erdos-Rényi graphs of size " << n << "." << std::endl;
-            std::cout << "The graph contains " << gER.get_number_of_edges() << " edges." << std::endl;
+            if (world_rank == 0) {
+                std::cout << "\nComparing MST algorithms with Erdos-Rényi graphs of size " << n << "." << std::endl;
+                std::cout << "The part of the graph held by the first processor contains " << gER.get_graph()->get_number_of_edges() << " edges." << std::endl;
+            }
 
-            PrimKumarAlgorithm primER = PrimKumarAlgorithm(&gER, world_rank, world_size);
+            PrimKumarAlgorithm primER = PrimKumarAlgorithm(&gER);
             primER.compute_mst();
 
+            if (num_threads > 1) {
+                PrimKumarAlgorithm hybridER = PrimKumarAlgorithm(&gER, num_threads);
+                hybridER.compute_mst();
+            }
+
+            DistributedBoruvkaAlgorithm boruvkaER = DistributedBoruvkaAlgorithm(&gER);
+            boruvkaER.compute_mst();
 
         }
 
@@ -139,13 +277,23 @@ int main(int argc, char** argv){
 
         for (int n : BA_graph_sizes) 
         {
-            Graph gBA = Graph("data/BAn" + std::to_string(n) + "mo20m2.txt");
+            GraphPartition gBA = GraphPartition("data/BAn" + std::to_string(n) + "mo20m2.txt", world_rank, world_size);
 
-            std::cout << "\nComparing MST algorithms with Barabasi-Albert graphs of size " << n << "." << std::endl;
-            std::cout << "The graph contains " << gBA.get_number_of_edges() << " edges." << std::endl;
+            if (world_rank == 0) {
+                std::cout << "\nComparing MST algorithms with Barabasi-Albert graphs of size " << n << "." << std::endl;
+                std::cout << "The part of the graph held by the first processor contains " << gBA.get_graph()->get_number_of_edges() << " edges." << std::endl;
+            }
 
-            PrimKumarAlgorithm primBA = PrimKumarAlgorithm(&gBA, world_rank, world_size);
+            PrimKumarAlgorithm primBA = PrimKumarAlgorithm(&gBA);
             primBA.compute_mst();
+
+            if (num_threads > 1) {
+                PrimKumarAlgorithm hybridBA = PrimKumarAlgorithm(&gBA, num_threads);
+                hybridBA.compute_mst();
+            }
+
+            DistributedBoruvkaAlgorithm boruvkaBA = DistributedBoruvkaAlgorithm(&gBA);
+            boruvkaBA.compute_mst();
         }
         
         MPI_Finalize();
@@ -168,11 +316,26 @@ int main(int argc, char** argv){
                 std::cout << "\nComparing MST clustering and k-means on graph of size " << n;
                 std::cout << " and with " << k << " clusters" << std::endl;
 
-                compare_clustering("data/scaled_n" + std::to_string(n) + "_walmart_features.txt", k);
+                compare_clustering("data/scaled_n" + std::to_string(n) + "_walmart_features.txt", k, silhouette_sample, kmeans_mode, kmeans_init);
             }
         }
     }
 
+    if (!stream_file.empty())
+    {
+        // Streaming k-means, whose memory does not depend on the size of the file
+
+        std::vector<int> nb_clusters({3, 4, 5, 6, 7, 8});
+
+        for (int k : nb_clusters)
+        {
+            std::cout << "\nClustering " << stream_file << " with streaming k-means";
+            std::cout << " and with " << k << " clusters" << std::endl;
+
+            stream_clustering(stream_file, k);
+        }
+    }
+
     // TASK 6 
 
     if (run_mst_inc)
@@ -183,7 +346,7 @@ int main(int argc, char** argv){
         std::vector<double> ER_cutoffs({1, 5, 10, 50, 100, 500, 1000});
 
         for (double c : ER_cutoffs) {
-            Graph g = Graph("data/ERn1000p10.txt");
+            Graph g = Graph(graph_file("ERn1000p10"));
             KruskalAlgorithm k = KruskalAlgorithm(&g);
 
             std::unordered_map<Node*, Node*> clusters = k.compute_clustering(c);
@@ -216,7 +379,7 @@ int main(int argc, char** argv){
         std::vector<double> walmart_cutoffs({1, 5, 10, 50, 100, 500, 1000});
 
         for (double c : walmart_cutoffs) {
-            compare_inconsistency("data/scaled_n1000_walmart_features.txt", c);
+            compare_inconsistency("data/scaled_n1000_walmart_features.txt", c, kmeans_mode, kmeans_init);
         }
     }
 
@@ -90,52 +90,49 @@ std::unordered_map<Node*, Node*> MSTAlgorithm::compute_clustering(int k)
         this->compute_mst();
     }
 
-    int n = this->mst_graph.get_number_of_nodes();
-    assert(("There are less points than clusters!", k <= n));
+    const CSRGraph& csr = this->mst_graph.get_csr();
 
-    auto cmp = [](const Edge* e1, const Edge* e2) 
+    int n = csr.n;
+    assert(k <= n && "There are less points than clusters!");
+
+    auto cmp = [&csr](const edge_id_t e1, const edge_id_t e2) 
         { 
-            double w1 = e1->weight;
-            double w2 = e2->weight;
+            double w1 = csr.edges[e1].weight;
+            double w2 = csr.edges[e2].weight;
 
             if (w1 < w2) {
                 return false;
             } else if (w1 > w2) {
                 return true;
             } else { // Allows multiple keys for same weight values
-                intptr_t p1 = reinterpret_cast<intptr_t>(e1);
-                intptr_t p2 = reinterpret_cast<intptr_t>(e2);
-
-                return p1 < p2;
+                return e1 > e2;
             }
         };
 
     // builds an ordered queue of the edges of the MST graph
-    std::unordered_set<Edge*> mst_edges = this->mst_graph.get_edges();
-
-    std::priority_queue<Edge*, std::vector<Edge*>, decltype(cmp)> pq(cmp);
+    std::priority_queue<edge_id_t, std::vector<edge_id_t>, decltype(cmp)> pq(cmp);
 
-    for (Edge* e : mst_edges) {
+    for (edge_id_t e = 0; e < csr.m; e ++) {
         pq.push(e);
     }
 
     // selects only the E-(k-1) lightest edges of the MST graph
-    std::vector<Node*> nodes = this->mst_graph.get_nodes();
-    UnionFind uf = UnionFind(nodes);
+    FlatUnionFind uf = FlatUnionFind(n);
 
     int nb_edges = (n-1) - (k-1); // MST is a tree 
 
     for (int i = 0; i < nb_edges; i ++) {
-        Edge* min_edge = pq.top();
-        uf.Union(min_edge->p1, min_edge->p2);
+        edge_id_t min_edge = pq.top();
+        uf.Union(csr.edges[min_edge].u, csr.edges[min_edge].v);
         pq.pop();
     }
 
     // builds a map from all the nodes to their representatives 
     std::unordered_map<Node*, Node*> clusters;
 
-    for (Node* node : nodes) {
-        Node* rep = uf.Find(node);
+    for (node_id_t u = 0; u < n; u ++) {
+        Node* node = this->mst_graph.get_node(u);
+        Node* rep = this->mst_graph.get_node(uf.Find(u));
 
         clusters.insert(std::pair<Node*, Node*>(node, rep));
     }
@@ -162,37 +159,16 @@ std::unordered_map<Node*, Node*> MSTAlgorithm::compute_clustering(double cutoff)
         this->compute_mst();
     }
 
-    auto cmp = [](const Edge* e1, const Edge* e2) 
-        { 
-            double w1 = e1->weight;
-            double w2 = e2->weight;
-
-            if (w1 < w2) {
-                return false;
-            } else if (w1 > w2) {
-                return true;
-            } else { // Allows multiple keys for same weight values
-                intptr_t p1 = reinterpret_cast<intptr_t>(e1);
-                intptr_t p2 = reinterpret_cast<intptr_t>(e2);
-
-                return p1 < p2;
-            }
-        };
-
     // builds an union-find ds and initializes the edges
-    std::unordered_set<Edge*> mst_edges = this->mst_graph.get_edges();
+    const CSRGraph& csr = this->mst_graph.get_csr();
 
-    std::vector<Node*> nodes = this->mst_graph.get_nodes();
-    UnionFind uf = UnionFind(nodes);
+    FlatUnionFind uf = FlatUnionFind(csr.n);
 
     // passes through the MST edges and keeps the consistent edges
     
-    for (Edge* e : mst_edges) {
+    for (const WeightedEdge& e : csr.edges) {
         bool add_edge = true;
 
-        Node* p1 = e->p1;
-        Node* p2 = e->p2;
-
         double avg_weight = 0.0;
         double std_dev = 0.0;
         double cnt = 0.0;
@@ -200,21 +176,15 @@ std::unordered_map<Node*, Node*> MSTAlgorithm::compute_clustering(double cutoff)
         double edge_std_dev = 0.0;
 
         // computes mean weight and std deviation for edges on both sides
-        for (Edge* e1 : this->mst_graph.connected_edges(p1)) {
-            if (e1 != e) {
-                double edge_weight = e1->weight;
-                avg_weight += edge_weight;
-                std_dev += edge_weight*edge_weight;
-                cnt += 1;
-            }
-        }
-
-        for (Edge* e2 : this->mst_graph.connected_edges(p2)) {
-            if (e2 != e) {
-                double edge_weight = e2->weight;
-                avg_weight += edge_weight;
-                std_dev += edge_weight*edge_weight;
-                cnt += 1;
+        node_id_t ends[2] = {e.u, e.v};
+        for (node_id_t end : ends) {
+            for (int slot = csr.offsets[end]; slot < csr.offsets[end+1]; slot ++) {
+                if (csr.edge_ids[slot] != e.id) {
+                    double edge_weight = csr.weights[slot];
+                    avg_weight += edge_weight;
+                    std_dev += edge_weight*edge_weight;
+                    cnt += 1;
+                }
             }
         }
 
@@ -222,22 +192,23 @@ std::unordered_map<Node*, Node*> MSTAlgorithm::compute_clustering(double cutoff)
         std_dev = std::sqrt((std_dev/cnt) - avg_weight*avg_weight);
 
         // discards the considered edge if its std deviation is too large 
-        edge_std_dev = std::abs(e->weight - avg_weight);
+        edge_std_dev = std::abs(e.weight - avg_weight);
         if (edge_std_dev >= cutoff*std_dev) {
             add_edge = false;
         }
 
         // adds the edge if it is consistent
         if (add_edge == true) {
-            uf.Union(p1, p2);
+            uf.Union(e.u, e.v);
         }
     }
 
     // builds a map from all the nodes to their representatives 
     std::unordered_map<Node*, Node*> clusters;
 
-    for (Node* node : nodes) {
-        Node* rep = uf.Find(node);
+    for (node_id_t u = 0; u < csr.n; u ++) {
+        Node* node = this->mst_graph.get_node(u);
+        Node* rep = this->mst_graph.get_node(uf.Find(u));
 
         clusters.insert(std::pair<Node*, Node*>(node, rep));
     }
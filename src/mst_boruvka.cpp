@@ -1,15 +1,28 @@
 #include "mst_boruvka.hpp"
 
-BoruvkaAlgorithm::BoruvkaAlgorithm(Graph* graph) : MSTAlgorithm(graph) {}
+BoruvkaAlgorithm::BoruvkaAlgorithm(Graph* graph, int num_threads_) : MSTAlgorithm(graph) 
+{
+    /*!
+     * @brief Builds the MST "solver" of \p graph
+     * 
+     * @param graph The graph
+     * @param num_threads_ The number of threads, 0 meaning one per hardware core
+     * 
+     */
+
+    this->num_threads = resolve_num_threads(num_threads_);
+}
 
 void BoruvkaAlgorithm::compute_mst() 
 {
     /*!
      * @brief Computes the Minimum Spanning Tree of the graph associated to 
      * this instance of MSTAlgorithm, using Boruvka's algorithm. More specifically,
-     * initializes a Union-Find data structure with all the nodes of the graph, 
-     * and unions connected components of the MST with respect to their edge of 
-     * minimal weight, until there is only one component left.
+     * at each round, the threads find in parallel the edge of minimal weight 
+     * leaving each component over their slice of the edges, then the components 
+     * are contracted along these edges in parallel, until there is only one 
+     * component left. Between two rounds, the edges are moved to the contracted 
+     * graph, so that each round only scans edges between distinct components.
      * 
      */
 
@@ -18,65 +31,116 @@ void BoruvkaAlgorithm::compute_mst()
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
     // initialization of the algorithm
-    std::unordered_set<Edge*> edges = this->initial_graph->get_edges();
+    const CSRGraph& csr = this->initial_graph->get_csr();
     std::vector<Node*> nodes = this->initial_graph->get_nodes();
     for(Node* n : nodes) {
         this->mst_graph.add_node(n);
     }
 
-    UnionFind uf = UnionFind(nodes);
+    int n = csr.n;
+    ThreadPool pool(this->num_threads);
+
+    // the rank of an edge in the (weight, id) order packs both keys in a single 
+    // word, hence the lightest edge of a component is an atomic minimum
+    std::vector<WeightedEdge> edges = csr.edges;
+    radix_sort_edges(edges);
+
+    const uint64_t no_edge = std::numeric_limits<uint64_t>::max();
+
+    // the nodes of the contracted graph are the components, labelled in [0, k)
+    std::vector<node_id_t> next(n);    // root of the component after contraction
+    std::vector<node_id_t> jumped(n);
+    std::vector<node_id_t> label(n);   // label of the roots in the next round
+    std::vector<std::atomic<uint64_t>> min_edges(n);
 
     // filling the MST with edges until there is only one component left
-    int k = uf.get_num_classes();
+    int k = n;
     while (k > 1) {
 
-        // for each component, we will keep track of the external edge with minimal weight
-        std::unordered_set<Node*> representatives = uf.get_representatives();
-        std::unordered_map<Node*, Edge*> min_edges;
-        for (Node* rep : representatives) {
-            min_edges.insert(std::pair<Node*, Edge*>(rep, NULL));
-        }
+        int m = edges.size();
 
-        // getting all the edges with minimal weights according to components (not best complexity here)
-        for (Edge*  e : edges) {
+        pool.run(k, [&](int, int begin, int end) {
+            for (node_id_t u = begin; u < end; u ++) {
+                min_edges[u].store(no_edge, std::memory_order_relaxed);
+            }
+        });
 
-            Node* n_in = e->p1;
-            Node* n_out = e->p2;
+        // each thread looks for the lightest external edges over its slice of edges
+        pool.run(m, [&](int, int begin, int end) {
+            for (int rank = begin; rank < end; rank ++) {
+                node_id_t rep_in = edges[rank].u;
+                node_id_t rep_out = edges[rank].v;
 
-            Node* rep_in = uf.Find(n_in);
-            Node* rep_out = uf.Find(n_out);
+                if (rep_in != rep_out) {
+                    atomic_min(min_edges[rep_in], rank);
+                    atomic_min(min_edges[rep_out], rank);
+                }
+            }
+        });
 
-            if (rep_in == rep_out) {
-                continue;
+        // each component points to the component at the other end of its lightest 
+        // edge, and of two components choosing the same edge the smallest becomes a root
+        pool.run(k, [&](int, int begin, int end) {
+            for (node_id_t u = begin; u < end; u ++) {
+                next[u] = u;
+                uint64_t rank = min_edges[u].load(std::memory_order_relaxed);
+                if (rank == no_edge) {
+                    continue;
+                }
+
+                node_id_t other = (edges[rank].u == u) ? edges[rank].v : edges[rank].u;
+                if (min_edges[other].load(std::memory_order_relaxed) != rank || u > other) {
+                    next[u] = other;
+                }
             }
+        });
 
-            if (min_edges.at(rep_in) == NULL || min_edges.at(rep_in)->weight > e->weight) {
-                min_edges.erase(rep_in);
-                min_edges.insert(std::pair<Node*, Edge*>(rep_in, e));
+        // linking components
+        int num_roots = 0;
+        for (node_id_t u = 0; u < k; u ++) {
+            uint64_t rank = min_edges[u].load(std::memory_order_relaxed);
+            if (rank == no_edge) {
+                throw std::invalid_argument("No MST can be built !");
             }
 
-            if (min_edges.at(rep_out) == NULL || min_edges.at(rep_out)->weight > e->weight) {
-                min_edges.erase(rep_out);
-                min_edges.insert(std::pair<Node*, Edge*>(rep_out, e));
+            if (next[u] != u) {
+                const WeightedEdge& e = edges[rank];
+                this->mst_graph.add_edge(this->initial_graph->get_edge(e.id));
+                this->mst_weight += e.weight;
+            } else {
+                label[u] = num_roots++;
             }
-        
         }
 
-        // linking components
-        for (Node* rep : representatives) {
-            Edge* min_edge = min_edges.at(rep);
+        // contracting components with pointer jumping, until all point to a root
+        std::atomic<bool> changed(true);
+        while (changed.load()) {
+            changed.store(false);
 
-            Node* rep1 = uf.Find(min_edge->p1);
-            Node* rep2 = uf.Find(min_edge->p2);
+            pool.run(k, [&](int, int begin, int end) {
+                bool local_changed = false;
+                for (node_id_t u = begin; u < end; u ++) {
+                    jumped[u] = next[next[u]];
+                    local_changed = local_changed || (jumped[u] != next[u]);
+                }
+                if (local_changed) {
+                    changed.store(true);
+                }
+            });
 
-            if (rep1 != rep2) {
-                this->mst_graph.add_edge(min_edge);
-                this->mst_weight += min_edge->weight;
-                uf.Union(rep1, rep2);
-            }
+            next.swap(jumped);
         }
 
-        k = uf.get_num_classes();
+        pool.run(k, [&](int, int begin, int end) {
+            for (node_id_t u = begin; u < end; u ++) {
+                next[u] = label[next[u]];
+            }
+        });
+
+        k = num_roots;
+        if (k > 1) {
+            BoruvkaAlgorithm::contract_edges(edges, next, k, pool);
+        }
     }
 
     std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
@@ -86,4 +150,157 @@ void BoruvkaAlgorithm::compute_mst()
     std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
 
     std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
-}
\ No newline at end of file
+}
+void BoruvkaAlgorithm::contract_edges(std::vector<WeightedEdge>& edges, const std::vector<node_id_t>& label, int k, ThreadPool& pool)
+{
+    /*!
+     * @brief Moves the edges to the contracted graph, dropping the edges inside 
+     * a component and keeping only the lightest edge between two components. 
+     * The order of the remaining edges is preserved. Each pass over the edges, 
+     * relabelling, bucketing by smallest endpoint, deduplication and 
+     * compaction, is shared between the threads.
+     * 
+     * @param edges The edges, sorted by (weight, id), whose endpoints are 
+     * replaced by the labels of their components
+     * @param label The label in [0, k) of the new component of each node
+     * @param k The number of nodes of the contracted graph
+     * @param pool The threads
+     * 
+     */
+
+    int m = edges.size();
+    int num_threads = pool.get_num_threads();
+
+    std::vector<char> kept(m);
+
+    // relabelling the endpoints, and dropping the edges inside a component
+    pool.run(m, [&](int, int begin, int end) {
+        for (int i = begin; i < end; i ++) {
+            WeightedEdge& e = edges[i];
+            e.u = label[e.u];
+            e.v = label[e.v];
+            kept[i] = (e.u != e.v);
+        }
+    });
+
+    // the edges are split into chunks, each of them counting its edges per
+    // bucket in its own row of k integers; there are few enough chunks for
+    // these rows to take no more memory than the edges
+    int num_chunks = std::max(1, (int) std::min<long long>(num_threads, 4LL * m / (k+1)));
+    std::vector<int> chunk_rows((size_t) num_chunks * k, 0);
+
+    auto chunk_row = [&](int c) { return chunk_rows.data() + (size_t) c * k; };
+    auto chunk_begin = [&](int c) { return (int) ((long long) m * c / num_chunks); };
+
+    // bucketing the edges by smallest endpoint, in order of weight within a bucket
+    pool.run(num_chunks, [&](int, int begin, int end) {
+        for (int c = begin; c < end; c ++) {
+            int* count = chunk_row(c);
+            for (int i = chunk_begin(c); i < chunk_begin(c+1); i ++) {
+                if (kept[i]) {
+                    count[std::min(edges[i].u, edges[i].v)] += 1;
+                }
+            }
+        }
+    });
+
+    // first slot of each bucket, with a prefix sum over the buckets of each
+    // thread then over the threads, the row of each chunk becoming its next
+    // slot in each bucket
+    std::vector<int> offsets(k+1, 0);
+    std::vector<int> thread_offsets(num_threads+1, 0);
+
+    pool.run(k, [&](int thread, int begin, int end) {
+        int sum = 0;
+        for (int u = begin; u < end; u ++) {
+            for (int c = 0; c < num_chunks; c ++) {
+                sum += chunk_row(c)[u];
+            }
+        }
+        thread_offsets[thread+1] = sum;
+    });
+
+    for (int t = 0; t < num_threads; t ++) {
+        thread_offsets[t+1] += thread_offsets[t];
+    }
+
+    pool.run(k, [&](int thread, int begin, int end) {
+        int slot = thread_offsets[thread];
+        for (int u = begin; u < end; u ++) {
+            offsets[u] = slot;
+            for (int c = 0; c < num_chunks; c ++) {
+                int count = chunk_row(c)[u];
+                chunk_row(c)[u] = slot;
+                slot += count;
+            }
+        }
+    });
+    offsets[k] = thread_offsets[num_threads];
+
+    std::vector<int> buckets(offsets[k]);
+    pool.run(num_chunks, [&](int, int begin, int end) {
+        for (int c = begin; c < end; c ++) {
+            int* next_slot = chunk_row(c);
+            for (int i = chunk_begin(c); i < chunk_begin(c+1); i ++) {
+                if (kept[i]) {
+                    buckets[next_slot[std::min(edges[i].u, edges[i].v)]++] = i;
+                }
+            }
+        }
+    });
+
+    // only the first, hence lightest, edge towards each other endpoint is 
+    // kept; each chunk goes through a range of buckets holding as many edges 
+    // as the others, its row now marking the endpoints already seen
+    auto bucket_begin = [&](int c) {
+        if (c == num_chunks) {
+            return k;
+        }
+        long long first_slot = (long long) offsets[k] * c / num_chunks;
+        return (int) (std::lower_bound(offsets.begin(), offsets.begin() + k, first_slot) - offsets.begin());
+    };
+
+    pool.run(num_chunks, [&](int, int begin, int end) {
+        for (int c = begin; c < end; c ++) {
+            node_id_t* seen = chunk_row(c);
+            std::fill(seen, seen + k, -1);
+
+            for (node_id_t u = bucket_begin(c); u < bucket_begin(c+1); u ++) {
+                for (int slot = offsets[u]; slot < offsets[u+1]; slot ++) {
+                    int i = buckets[slot];
+                    node_id_t v = std::max(edges[i].u, edges[i].v);
+
+                    if (seen[v] == u) {
+                        kept[i] = false;
+                    } else {
+                        seen[v] = u;
+                    }
+                }
+            }
+        }
+    });
+
+    // stable compaction, each thread writing its kept edges after those of the previous threads
+    std::vector<int> counts(num_threads+1, 0);
+    pool.run(m, [&](int thread, int begin, int end) {
+        for (int i = begin; i < end; i ++) {
+            counts[thread+1] += kept[i];
+        }
+    });
+
+    for (int t = 0; t < num_threads; t ++) {
+        counts[t+1] += counts[t];
+    }
+
+    std::vector<WeightedEdge> contracted(counts[num_threads]);
+    pool.run(m, [&](int thread, int begin, int end) {
+        int position = counts[thread];
+        for (int i = begin; i < end; i ++) {
+            if (kept[i]) {
+                contracted[position++] = edges[i];
+            }
+        }
+    });
+
+    edges.swap(contracted);
+}
@@ -1,14 +1,38 @@
 #pragma once
 
 #include "mst_algorithm.hpp"
-#include "union_find.hpp"
+#include "radix_sort.hpp"
+#include "thread_pool.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
+#include <atomic>
+#include <limits>
+#include <cstdint>
 
 class BoruvkaAlgorithm : public MSTAlgorithm
 {
+private:
+    int num_threads;
+
 public:
-    BoruvkaAlgorithm(Graph* graph);
+    BoruvkaAlgorithm(Graph* graph, int num_threads_ = 0);
 
     virtual void compute_mst();
-};
\ No newline at end of file
+
+    static void contract_edges(std::vector<WeightedEdge>& edges, const std::vector<node_id_t>& label, int k, ThreadPool& pool);
+};
+
+inline void atomic_min(std::atomic<uint64_t>& word, uint64_t value)
+{
+    /*!
+     * @brief Lowers the value of \p word to \p value if it is smaller, using
+     * compare-and-swap
+     *
+     */
+
+    uint64_t current = word.load(std::memory_order_relaxed);
+    while (value < current && !word.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
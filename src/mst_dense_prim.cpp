@@ -0,0 +1,115 @@
+#include "mst_dense_prim.hpp"
+#include "distance.hpp"
+
+DensePrimAlgorithm::DensePrimAlgorithm(std::vector<Point*> points_) : MSTAlgorithm(NULL) 
+{
+    /*!
+     * @brief Builds the MST "solver" of the complete graph over \p points_
+     * 
+     * @param points_ The points, which are the nodes of the implicit graph
+     * 
+     * @note There is no initial graph, hence \ref MSTAlgorithm::get_initial_graph 
+     * returns NULL for this algorithm
+     * 
+     */
+
+    this->points = points_;
+}
+
+void DensePrimAlgorithm::compute_mst() 
+{
+    /*!
+     * @brief Computes the Minimum Spanning Tree of the complete graph over the 
+     * points using the array-based version of Prim's algorithm, in O(n^2) time 
+     * and O(n) memory. At each iteration, the distances from the last node added 
+     * to the MST are used to update the best distance of the remaining nodes, and 
+     * the closest one is added. Squared distances are compared, which leads to 
+     * the same tree, and only the n-1 edges of the MST are created. The 
+     * coordinates of the remaining nodes are kept contiguous, so that the 
+     * distances from the last node added are computed by a single batch call.
+     * 
+     */
+
+    this->mst_weight = 0.0;
+    std::cout << "\nComputing the MST using dense Prim's algorithm...";
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    int n = this->points.size();
+
+    std::vector<Node*> nodes(n);
+    for (int i = 0; i < n; i ++) {
+        nodes[i] = new Node(i, this->points[i]);
+    }
+
+    if (n > 0) {
+        this->mst_graph.add_node(nodes[0]); // just to have the source node in the MST
+    }
+
+    // nodes outside of the tree are kept contiguous in remaining[0, nb_remaining), 
+    // along with their best squared distance and closest node in the tree
+    int nb_remaining = (n > 0) ? n-1 : 0;
+
+    int d = (n > 0) ? this->points[0]->get_dim() : 0;
+
+    std::vector<int> remaining(nb_remaining);
+    std::vector<double> remaining_coords((size_t) nb_remaining * d);
+    std::vector<double> best_dist(nb_remaining, std::numeric_limits<double>::infinity());
+    std::vector<int> best_parent(nb_remaining, 0);
+    std::vector<double> dists(nb_remaining);
+
+    for (int r = 0; r < nb_remaining; r ++) {
+        remaining[r] = r+1; // node 0 is the source
+        std::copy(this->points[r+1]->coords, this->points[r+1]->coords + d, remaining_coords.begin() + (size_t) r*d);
+    }
+
+    int current_node = 0;
+    std::vector<double> current_coords(d);
+    if (n > 0) {
+        std::copy(this->points[0]->coords, this->points[0]->coords + d, current_coords.begin());
+    }
+
+    while (nb_remaining > 0) {
+
+        squared_distances(current_coords.data(), remaining_coords.data(), nb_remaining, d, dists.data());
+
+        // updating the best distances with the last node added, and finding the closest
+        int closest = 0;
+        for (int r = 0; r < nb_remaining; r ++) {
+            double dist = dists[r];
+            if (dist < best_dist[r]) {
+                best_dist[r] = dist;
+                best_parent[r] = current_node;
+            }
+
+            if (best_dist[r] < best_dist[closest]) {
+                closest = r;
+            }
+        }
+
+        // adding the closest node to the MST
+        int new_node = remaining[closest];
+        double weight = std::sqrt(best_dist[closest]);
+
+        this->mst_graph.add_edge(new Edge(nodes[best_parent[closest]], nodes[new_node], weight));
+        this->mst_weight += weight;
+
+        // removing it from the remaining nodes
+        std::copy(remaining_coords.begin() + (size_t) closest*d, remaining_coords.begin() + (size_t) (closest+1)*d, current_coords.begin());
+
+        nb_remaining -= 1;
+        std::copy(remaining_coords.begin() + (size_t) nb_remaining*d, remaining_coords.begin() + (size_t) (nb_remaining+1)*d, remaining_coords.begin() + (size_t) closest*d);
+        remaining[closest] = remaining[nb_remaining];
+        best_dist[closest] = best_dist[nb_remaining];
+        best_parent[closest] = best_parent[nb_remaining];
+
+        current_node = new_node;
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "[OK]" << std::endl;
+    this->treatment_done();
+
+    std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
+
+    std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
+}
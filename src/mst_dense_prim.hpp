@@ -0,0 +1,25 @@
+#pragma once
+
+#include "mst_algorithm.hpp"
+
+#include <iostream>
+#include <limits>
+
+class DensePrimAlgorithm : public MSTAlgorithm
+{
+
+    /*!
+     * @class Prim's algorithm on the implicit complete Euclidean graph of a set 
+     * of points, where distances are computed on the fly instead of being 
+     * stored as edges
+     *
+     */
+
+private:
+    std::vector<Point*> points;
+
+public:
+    DensePrimAlgorithm(std::vector<Point*> points_);
+
+    virtual void compute_mst();
+};
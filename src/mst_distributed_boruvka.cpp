@@ -0,0 +1,218 @@
+#include "mst_distributed_boruvka.hpp"
+
+#include <iostream>
+#include <mpi.h>
+
+DistributedBoruvkaAlgorithm::DistributedBoruvkaAlgorithm(GraphPartition* partition_) : MSTAlgorithm(partition_->get_graph()) 
+{
+    /*!
+     * @brief Builds the MST "solver"
+     * 
+     * @param partition_ The part of the graph held by this processor, whose rank 
+     * and world size are used (MPI-related)
+     *
+     */
+
+    this->partition = partition_;
+    this->rank = partition_->get_rank();
+    this->world_size = partition_->get_world_size();
+}
+
+int DistributedBoruvkaAlgorithm::partition_edges()
+{
+    /*!
+     * @brief Keeps the edges owned by this processor, sorted by (weight, id). 
+     * Nodes are identified by the rank of their label among all the labels 
+     * known by the processors, which may be sparse, and the owned edges of 
+     * each processor get a contiguous block of global identifiers.
+     * 
+     * @return The number of nodes over all processors
+     * 
+     */
+
+    this->owned_edges = this->partition->get_owned_edges();
+    int m = this->owned_edges.size();
+
+    this->first_edge_id = 0;
+    MPI_Exscan(&m, &this->first_edge_id, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if (this->rank == 0) {
+        this->first_edge_id = 0;  // undefined on the first processor
+    }
+
+    // labels of the owned nodes and of the endpoints of the owned edges
+    std::vector<node_label_t> my_labels;
+    for (Node* n : this->partition->get_owned_nodes()) {
+        my_labels.push_back(n->label);
+    }
+
+    for (Edge* e : this->owned_edges) {
+        my_labels.push_back(e->p1->label);
+        my_labels.push_back(e->p2->label);
+    }
+
+    std::sort(my_labels.begin(), my_labels.end());
+    my_labels.erase(std::unique(my_labels.begin(), my_labels.end()), my_labels.end());
+
+    int n_mine = my_labels.size();
+    std::vector<int> n_labels(this->world_size);
+    MPI_Allgather(&n_mine, 1, MPI_INT, n_labels.data(), 1, MPI_INT, MPI_COMM_WORLD);
+
+    std::vector<int> label_offsets(this->world_size+1, 0);
+    for (int r = 0; r < this->world_size; r ++) {
+        label_offsets[r+1] = label_offsets[r] + n_labels[r];
+    }
+
+    std::vector<node_label_t> all_labels(label_offsets[this->world_size]);
+    MPI_Allgatherv(my_labels.data(), n_mine, MPI_INT, all_labels.data(), n_labels.data(), label_offsets.data(), MPI_INT, MPI_COMM_WORLD);
+
+    // dense identifiers, in order of labels
+    std::sort(all_labels.begin(), all_labels.end());
+    all_labels.erase(std::unique(all_labels.begin(), all_labels.end()), all_labels.end());
+
+    auto dense_id = [&all_labels](node_label_t label) {
+        return (node_id_t) (std::lower_bound(all_labels.begin(), all_labels.end(), label) - all_labels.begin());
+    };
+
+    this->local_edges.resize(m);
+    for (int i = 0; i < m; i ++) {
+        Edge* e = this->owned_edges[i];
+
+        this->local_edges[i].weight = e->weight;
+        this->local_edges[i].u = dense_id(e->p1->label);
+        this->local_edges[i].v = dense_id(e->p2->label);
+        this->local_edges[i].id = this->first_edge_id + i;
+    }
+
+    radix_sort_edges(this->local_edges);
+
+    return all_labels.size();
+}
+
+void DistributedBoruvkaAlgorithm::compute_mst() 
+{
+    /*!
+     * @brief Computes the Minimum Spanning Tree of the initial graph using 
+     * a distributed Boruvka's algorithm, where each processor only scans its 
+     * own block of edges. At each round, the lightest edge leaving each component 
+     * is elected by a single reduction over all processors, then every processor 
+     * merges the components along the elected edges and contracts its own edges. 
+     * The number of components at least halves at each round, hence there are 
+     * O(log n) rounds of two collective operations.
+     * 
+     * @note Each processor only adds to its MST graph the elected edges it owns, 
+     * but all of them compute the total weight.
+     * 
+     */
+
+    this->mst_weight = 0.0;
+
+    std::chrono::steady_clock::time_point begin;
+    if (this->rank == 0) {
+        std::cout << "Computing the MST using distributed Boruvka's algorithm...";
+        begin = std::chrono::steady_clock::now();
+    }
+
+    for (Node* n : this->partition->get_owned_nodes()) {
+        this->mst_graph.add_node(n);
+    }
+
+    int n = this->partition_edges();
+
+    // a (weight, id) pair, with the layout of MPI_DOUBLE_INT, so that MPI_MINLOC 
+    // elects the lightest edge and breaks ties by identifier
+    struct min_edge_t {double weight; int edge_id;};
+
+    const double no_weight = std::numeric_limits<double>::infinity();
+    const int no_edge = std::numeric_limits<int>::max();
+
+    // the nodes of the contracted graph are the components, labelled in [0, k)
+    int k = n;
+
+    std::vector<min_edge_t> local_min(k), global_min(k);
+    std::vector<int> local_endpoints(2*k), global_endpoints(2*k);
+    std::vector<node_id_t> label(k);
+    ThreadPool pool(1);
+
+    while (k > 1) {
+
+        // lightest local edge leaving each component, the edges being sorted
+        for (int c = 0; c < k; c ++) {
+            local_min[c].weight = no_weight;
+            local_min[c].edge_id = no_edge;
+        }
+
+        for (const WeightedEdge& e : this->local_edges) {
+            if (e.u == e.v) {
+                continue;
+            }
+
+            if (local_min[e.u].edge_id == no_edge) {
+                local_min[e.u].weight = e.weight;
+                local_min[e.u].edge_id = e.id;
+                local_endpoints[2*e.u] = e.u;
+                local_endpoints[2*e.u+1] = e.v;
+            }
+
+            if (local_min[e.v].edge_id == no_edge) {
+                local_min[e.v].weight = e.weight;
+                local_min[e.v].edge_id = e.id;
+                local_endpoints[2*e.v] = e.u;
+                local_endpoints[2*e.v+1] = e.v;
+            }
+        }
+
+        MPI_Allreduce(local_min.data(), global_min.data(), k, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+
+        // the processor owning the elected edge shares its endpoints
+        for (int c = 0; c < k; c ++) {
+            if (global_min[c].edge_id == no_edge) {
+                throw std::invalid_argument("No MST can be built !");
+            }
+
+            if (local_min[c].edge_id != global_min[c].edge_id) {
+                local_endpoints[2*c] = -1;
+                local_endpoints[2*c+1] = -1;
+            }
+        }
+
+        MPI_Allreduce(local_endpoints.data(), global_endpoints.data(), 2*k, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+
+        // every processor merges the same components, an edge elected twice being added once
+        FlatUnionFind uf = FlatUnionFind(k);
+        for (int c = 0; c < k; c ++) {
+            if (uf.Union(global_endpoints[2*c], global_endpoints[2*c+1])) {
+                int local_id = global_min[c].edge_id - this->first_edge_id;
+                if (local_id >= 0 && local_id < (int) this->owned_edges.size()) {
+                    this->mst_graph.add_edge(this->owned_edges[local_id]);
+                }
+                this->mst_weight += global_min[c].weight;
+            }
+        }
+
+        int num_roots = 0;
+        for (int c = 0; c < k; c ++) {
+            if (uf.Find(c) == c) {
+                label[c] = num_roots++;
+            }
+        }
+
+        for (int c = 0; c < k; c ++) {
+            label[c] = label[uf.Find(c)];
+        }
+
+        k = num_roots;
+        if (k > 1) {
+            BoruvkaAlgorithm::contract_edges(this->local_edges, label, k, pool);
+        }
+    }
+
+    if (this->rank == 0) {
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << "[OK]" << std::endl;
+        this->treatment_done();
+
+        std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
+
+        std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
+    }
+}
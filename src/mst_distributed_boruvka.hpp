@@ -0,0 +1,29 @@
+#pragma once
+
+#include "mst_algorithm.hpp"
+#include "mst_boruvka.hpp"
+#include "graph_partition.hpp"
+#include "radix_sort.hpp"
+#include "union_find.hpp"
+
+#include <limits>
+#include <stdexcept>
+
+class DistributedBoruvkaAlgorithm : public MSTAlgorithm
+{
+    private:
+        GraphPartition* partition;
+        int world_size;
+        int rank;
+
+        std::vector<WeightedEdge> local_edges;
+        std::vector<Edge*> owned_edges;  // indexed by the local edge identifiers
+        int first_edge_id;               // global identifier of the first owned edge
+
+        int partition_edges();
+
+    public:
+        DistributedBoruvkaAlgorithm(GraphPartition* partition_);
+
+        virtual void compute_mst();
+};
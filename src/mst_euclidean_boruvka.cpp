@@ -0,0 +1,253 @@
+#include "mst_euclidean_boruvka.hpp"
+#include "distance.hpp"
+
+#include <algorithm>
+#include <limits>
+
+EuclideanBoruvkaAlgorithm::EuclideanBoruvkaAlgorithm(std::vector<Point*> points_, int leaf_size_) : MSTAlgorithm(NULL) 
+{
+    /*!
+     * @brief Builds the MST "solver" of the complete Euclidean graph over \p points_
+     * 
+     * @param points_ The points, which are the nodes of the implicit graph
+     * @param leaf_size_ The maximal number of points in the leaves of the k-d tree
+     * 
+     * @note There is no initial graph, hence \ref MSTAlgorithm::get_initial_graph 
+     * returns NULL for this algorithm
+     * 
+     */
+
+    this->points = points_;
+    this->leaf_size = leaf_size_;
+    this->tree = NULL;
+}
+
+void EuclideanBoruvkaAlgorithm::compute_mst() 
+{
+    /*!
+     * @brief Computes the Euclidean Minimum Spanning Tree of the points using 
+     * dual-tree Boruvka's algorithm. More specifically, builds a k-d tree over 
+     * the points, then at each round traverses pairs of tree nodes to find the 
+     * shortest edge leaving each component, pruning the pairs of nodes which 
+     * belong to the same component or which are too far apart to improve the 
+     * components of the query node.
+     * 
+     */
+
+    this->mst_weight = 0.0;
+    std::cout << "\nComputing the MST using dual-tree Boruvka's algorithm...";
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    int n = this->points.size();
+
+    std::vector<Node*> nodes(n);
+    for (int i = 0; i < n; i ++) {
+        nodes[i] = new Node(i, this->points[i]);
+        this->mst_graph.add_node(nodes[i]);
+    }
+
+    KDTree tree = KDTree(this->points, this->leaf_size);
+    this->tree = &tree;
+
+    // components are tracked over the positions of the points in the tree
+    FlatUnionFind uf = FlatUnionFind(n);
+    this->component.resize(n);
+    this->node_component.resize(tree.nodes.size());
+    this->node_bound.resize(tree.nodes.size());
+    this->best_dist.resize(n);
+    this->best_from.resize(n);
+    this->best_to.resize(n);
+
+    while (uf.get_num_classes() > 1) {
+
+        this->update_node_components(uf);
+
+        std::fill(this->node_bound.begin(), this->node_bound.end(), std::numeric_limits<double>::infinity());
+        std::fill(this->best_dist.begin(), this->best_dist.end(), std::numeric_limits<double>::infinity());
+
+        this->find_component_neighbors(0, 0);
+
+        // linking components
+        for (int i = 0; i < n; i ++) {
+            if (this->component[i] != i) {
+                continue; // not a representative
+            }
+
+            int q = this->best_from[i];
+            int r = this->best_to[i];
+
+            if (uf.Union(q, r)) {
+                double weight = std::sqrt(this->best_dist[i]);
+
+                this->mst_graph.add_edge(new Edge(nodes[tree.index[q]], nodes[tree.index[r]], weight));
+                this->mst_weight += weight;
+            }
+        }
+    }
+
+    this->tree = NULL;
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "[OK]" << std::endl;
+    this->treatment_done();
+
+    std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
+
+    std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
+}
+
+void EuclideanBoruvkaAlgorithm::update_node_components(FlatUnionFind& uf)
+{
+    /*!
+     * @brief Refreshes the representative of each point, and of each tree node 
+     * whose points all belong to the same component
+     * 
+     * @param uf The components built so far
+     * 
+     */
+
+    int n = this->points.size();
+    for (int i = 0; i < n; i ++) {
+        this->component[i] = uf.Find(i);
+    }
+
+    // children are always stored after their parent
+    for (int node = this->tree->nodes.size()-1; node >= 0; node --) {
+        const KDNode& kd_node = this->tree->nodes[node];
+
+        if (this->tree->is_leaf(node)) {
+            int comp = this->component[kd_node.begin];
+            for (int i = kd_node.begin+1; i < kd_node.end && comp != -1; i ++) {
+                if (this->component[i] != comp) {
+                    comp = -1;
+                }
+            }
+            this->node_component[node] = comp;
+        } else {
+            int left_comp = this->node_component[kd_node.left];
+            int right_comp = this->node_component[kd_node.right];
+            this->node_component[node] = (left_comp == right_comp) ? left_comp : -1;
+        }
+    }
+}
+
+bool EuclideanBoruvkaAlgorithm::is_better(double dist, int q, int r, int comp)
+{
+    /*!
+     * @brief Checks whether the edge (q, r) is shorter than the best outgoing 
+     * edge of component \p comp. Ties are broken by the original positions of the 
+     * endpoints, so that all components agree on a single order of the edges.
+     * 
+     */
+
+    if (dist != this->best_dist[comp]) {
+        return dist < this->best_dist[comp];
+    }
+
+    const std::vector<int>& index = this->tree->index;
+    int a1 = std::min(index[q], index[r]);
+    int b1 = std::max(index[q], index[r]);
+    int a2 = std::min(index[this->best_from[comp]], index[this->best_to[comp]]);
+    int b2 = std::max(index[this->best_from[comp]], index[this->best_to[comp]]);
+
+    return a1 < a2 || (a1 == a2 && b1 < b2);
+}
+
+void EuclideanBoruvkaAlgorithm::find_component_neighbors(int query, int reference)
+{
+    /*!
+     * @brief Dual-tree traversal, which updates the best outgoing edges of the 
+     * components of the points of \p query with the points of \p reference
+     * 
+     * @param query Node of the tree whose points look for a neighbor
+     * @param reference Node of the tree whose points are candidate neighbors
+     * 
+     */
+
+    const KDTree& tree = *this->tree;
+
+    // all the points of both nodes are already connected
+    if (this->node_component[query] != -1 && this->node_component[query] == this->node_component[reference]) {
+        return;
+    }
+
+    // no pair of points is close enough to improve a component of query
+    double bound = this->node_bound[query];
+    if (this->node_component[query] != -1) {
+        bound = std::min(bound, this->best_dist[this->node_component[query]]);
+    }
+
+    if (tree.min_squared_distance(query, reference) > bound) {
+        return;
+    }
+
+    const KDNode& q_node = tree.nodes[query];
+    const KDNode& r_node = tree.nodes[reference];
+
+    if (tree.is_leaf(query) && tree.is_leaf(reference)) {
+        bound = 0.0;
+        int d = tree.d;
+
+        for (int q = q_node.begin; q < q_node.end; q ++) {
+            int comp = this->component[q];
+            const double* x = tree.get_coords(q);
+
+            // the point itself may be too far from the box of reference
+            if (tree.min_squared_distance(x, reference) > this->best_dist[comp]) {
+                bound = std::max(bound, this->best_dist[comp]);
+                continue;
+            }
+
+            for (int r = r_node.begin; r < r_node.end; r ++) {
+                if (this->component[r] == comp) {
+                    continue;
+                }
+
+                double dist = squared_distance(x, tree.get_coords(r), d);
+
+                if (dist <= this->best_dist[comp] && this->is_better(dist, q, r, comp)) {
+                    this->best_dist[comp] = dist;
+                    this->best_from[comp] = q;
+                    this->best_to[comp] = r;
+                }
+            }
+
+            bound = std::max(bound, this->best_dist[comp]);
+        }
+
+        this->node_bound[query] = std::min(this->node_bound[query], bound);
+        return;
+    }
+
+    if (tree.is_leaf(query)) {
+        // visiting the closest child of reference first
+        int first = r_node.left;
+        int second = r_node.right;
+        if (tree.min_squared_distance(query, second) < tree.min_squared_distance(query, first)) {
+            std::swap(first, second);
+        }
+
+        this->find_component_neighbors(query, first);
+        this->find_component_neighbors(query, second);
+        return;
+    }
+
+    int children[2] = {q_node.left, q_node.right};
+    for (int child : children) {
+        if (tree.is_leaf(reference)) {
+            this->find_component_neighbors(child, reference);
+        } else {
+            int first = r_node.left;
+            int second = r_node.right;
+            if (tree.min_squared_distance(child, second) < tree.min_squared_distance(child, first)) {
+                std::swap(first, second);
+            }
+
+            this->find_component_neighbors(child, first);
+            this->find_component_neighbors(child, second);
+        }
+    }
+
+    this->node_bound[query] = std::min(this->node_bound[query], 
+        std::max(this->node_bound[q_node.left], this->node_bound[q_node.right]));
+}
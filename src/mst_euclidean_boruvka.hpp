@@ -0,0 +1,39 @@
+#pragma once
+
+#include "mst_algorithm.hpp"
+#include "union_find.hpp"
+#include "kd_tree.hpp"
+
+#include <iostream>
+
+class EuclideanBoruvkaAlgorithm : public MSTAlgorithm
+{
+
+    /*!
+     * @class Euclidean MST of a set of points, computed with a dual-tree 
+     * Boruvka's algorithm over a k-d tree
+     *
+     */
+
+private:
+    std::vector<Point*> points;
+    int leaf_size;
+
+    // state of the current Boruvka round, indexed by positions in the tree
+    KDTree* tree;
+    std::vector<int> component;         // representative of each point
+    std::vector<int> node_component;    // representative shared by all the points of a node, -1 otherwise
+    std::vector<double> node_bound;     // no point of the node can improve its component beyond this distance
+    std::vector<double> best_dist;      // squared length of the best outgoing edge of each component
+    std::vector<int> best_from;
+    std::vector<int> best_to;
+
+    bool is_better(double dist, int q, int r, int comp);
+    void update_node_components(FlatUnionFind& uf);
+    void find_component_neighbors(int query, int reference);
+
+public:
+    EuclideanBoruvkaAlgorithm(std::vector<Point*> points_, int leaf_size_ = 16);
+
+    virtual void compute_mst();
+};
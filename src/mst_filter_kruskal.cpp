@@ -0,0 +1,133 @@
+#include "mst_filter_kruskal.hpp"
+
+#include <algorithm>
+
+// below this number of edges, the range is directly sorted
+#define FILTER_KRUSKAL_THRESHOLD 1024
+
+FilterKruskalAlgorithm::FilterKruskalAlgorithm(Graph* graph) : MSTAlgorithm(graph) 
+{
+    /*!
+     * @brief Builds the MST "solver"
+     * 
+     * @param graph The graph to use
+     * 
+     */
+
+    this->generator.seed(0); // reproducible pivots
+    this->accepted = 0;
+}
+
+void FilterKruskalAlgorithm::compute_mst()
+{
+    /*!
+     * @brief Computes the Minimum Spanning Tree of the initial graph using 
+     * Filter-Kruskal's algorithm. More specifically, partitions the edges 
+     * around a random pivot, recurses on the light edges, then filters out 
+     * the heavy edges whose endpoints are already connected before recursing 
+     * on the remaining ones. Small ranges are sorted and scanned as in Kruskal's 
+     * algorithm.
+     * 
+     */
+
+    this->mst_weight = 0.0;
+    std::cout << "\nComputing the MST using Filter-Kruskal's algorithm...";
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    const CSRGraph& csr = this->initial_graph->get_csr();
+
+    std::vector<WeightedEdge> edges = csr.edges;
+    FlatUnionFind uf = FlatUnionFind(csr.n);
+
+    this->accepted = 0;
+    this->filter_kruskal(edges, 0, csr.m, uf);
+
+    if (this->accepted < csr.n-1) {
+        throw std::invalid_argument("No MST can be built !");
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "[OK]" << std::endl;
+    this->treatment_done();
+
+    std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
+
+    std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
+}
+
+void FilterKruskalAlgorithm::filter_kruskal(std::vector<WeightedEdge>& edges, int lo, int hi, FlatUnionFind& uf)
+{
+    /*!
+     * @brief Recursive step of Filter-Kruskal on the edges [lo, hi)
+     * 
+     * @param edges The flat edges, partially reordered in place
+     * @param lo First edge of the range
+     * @param hi Past-the-end edge of the range
+     * @param uf The components built so far
+     * 
+     */
+
+    if (uf.get_num_classes() == 1) {
+        return; // the tree is complete, remaining edges are useless
+    }
+
+    if (hi - lo <= FILTER_KRUSKAL_THRESHOLD) {
+        this->kruskal(edges, lo, hi, uf);
+        return;
+    }
+
+    // edges are totally ordered by (weight, id), which splits ranges of equal weights
+    auto lighter = [](const WeightedEdge& e1, const WeightedEdge& e2) 
+        {
+            return e1.weight < e2.weight || (e1.weight == e2.weight && e1.id < e2.id);
+        };
+
+    // the pivot is the median of three random edges
+    std::uniform_int_distribution<int> distrib(lo, hi-1);
+    WeightedEdge candidates[3] = {edges[distrib(this->generator)], edges[distrib(this->generator)], edges[distrib(this->generator)]};
+    std::sort(candidates, candidates + 3, lighter);
+    WeightedEdge pivot = candidates[1];
+
+    // light edges are the ones lighter than or equal to the pivot
+    int mid = std::partition(edges.begin() + lo, edges.begin() + hi, 
+        [&pivot, &lighter](const WeightedEdge& e) { return !lighter(pivot, e); }) - edges.begin();
+
+    if (mid == hi) { // unlucky pivot (the heaviest edge), no progress can be made
+        this->kruskal(edges, lo, hi, uf);
+        return;
+    }
+
+    this->filter_kruskal(edges, lo, mid, uf);
+
+    // heavy edges inside a component can never be part of the MST
+    int kept = std::remove_if(edges.begin() + mid, edges.begin() + hi, 
+        [&uf](const WeightedEdge& e) { return uf.Find(e.u) == uf.Find(e.v); }) - edges.begin();
+
+    this->filter_kruskal(edges, mid, kept, uf);
+}
+
+void FilterKruskalAlgorithm::kruskal(std::vector<WeightedEdge>& edges, int lo, int hi, FlatUnionFind& uf)
+{
+    /*!
+     * @brief Base case of Filter-Kruskal: sorts the edges [lo, hi) and adds 
+     * them to the MST as in Kruskal's algorithm
+     * 
+     * @param edges The flat edges, partially reordered in place
+     * @param lo First edge of the range
+     * @param hi Past-the-end edge of the range
+     * @param uf The components built so far
+     * 
+     */
+
+    radix_sort_edges(edges.data() + lo, hi - lo);
+
+    for (int i = lo; i < hi && uf.get_num_classes() > 1; i ++) {
+        const WeightedEdge& e = edges[i];
+
+        if (uf.Union(e.u, e.v)) {
+            this->mst_graph.add_edge(this->initial_graph->get_edge(e.id));
+            this->mst_weight += e.weight;
+            this->accepted += 1;
+        }
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "mst_algorithm.hpp"
+#include "union_find.hpp"
+#include "radix_sort.hpp"
+
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+class FilterKruskalAlgorithm : public MSTAlgorithm
+{
+private:
+    std::mt19937 generator;
+    int accepted;
+
+    void filter_kruskal(std::vector<WeightedEdge>& edges, int lo, int hi, FlatUnionFind& uf);
+    void kruskal(std::vector<WeightedEdge>& edges, int lo, int hi, FlatUnionFind& uf);
+
+public:
+    FilterKruskalAlgorithm(Graph* graph);
+
+    virtual void compute_mst();
+};
@@ -1,6 +1,18 @@
 #include "mst_kruskal.hpp"
 
-KruskalAlgorithm::KruskalAlgorithm(Graph* graph) : MSTAlgorithm(graph) {}
+KruskalAlgorithm::KruskalAlgorithm(Graph* graph, KruskalMode mode_) : MSTAlgorithm(graph) 
+{
+    /*!
+     * @brief Builds the MST "solver"
+     * 
+     * @param graph The graph to use
+     * @param mode_ Whether the edges are ordered by a priority queue or by a 
+     * single sort of the flat edge array
+     * 
+     */
+
+    this->mode = mode_;
+}
 
 void KruskalAlgorithm::compute_mst()
 {
@@ -17,59 +29,101 @@ void KruskalAlgorithm::compute_mst()
     std::cout << "\nComputing the MST using Kruskal's algorithm...";
     std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
 
-    int n = this->initial_graph->get_number_of_nodes();
-    std::vector<Node*> nodes = this->initial_graph->get_nodes();
-    std::unordered_set<Edge*> edges = this->initial_graph->get_edges();
+    if (this->mode == KruskalMode::PriorityQueue) {
+        this->compute_mst_priority_queue();
+    } else {
+        this->compute_mst_sort();
+    }
+
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    std::cout << "[OK]" << std::endl;
+    this->treatment_done();
+
+    std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
+
+    std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
+}
+
+void KruskalAlgorithm::compute_mst_priority_queue()
+{
+    /*!
+     * @brief Kruskal's algorithm where the edges are popped from a priority queue
+     * 
+     */
+
+    const CSRGraph& csr = this->initial_graph->get_csr();
 
-    auto cmp = [](const Edge* e1, const Edge* e2) 
+    auto cmp = [&csr](const edge_id_t e1, const edge_id_t e2) 
         { 
-            double w1 = e1->weight;
-            double w2 = e2->weight;
+            double w1 = csr.edges[e1].weight;
+            double w2 = csr.edges[e2].weight;
 
             if (w1 < w2) {
                 return false; // reversed in order to follow priority queue's implementation
             } else if (w1 > w2) {
                 return true;
             } else { // allows multiple keys for same weight values (arbitrary comp)
-                intptr_t p1 = reinterpret_cast<intptr_t>(e1);
-                intptr_t p2 = reinterpret_cast<intptr_t>(e2);
-
-                return p1 < p2;
+                return e1 > e2;
             }
         };
 
     // initialization of the algorithm
-    std::priority_queue<Edge*, std::vector<Edge*>, decltype(cmp)> pq(cmp);
-    for (Edge* e : edges) {
+    std::priority_queue<edge_id_t, std::vector<edge_id_t>, decltype(cmp)> pq(cmp);
+    for (edge_id_t e = 0; e < csr.m; e ++) {
         pq.push(e);
     }
 
-    UnionFind uf = UnionFind(nodes);
+    FlatUnionFind uf = FlatUnionFind(csr.n);
 
     // while there is more than one component, we add edges that are shared 
     int k = uf.get_num_classes();
     while (k > 1) {
 
-        Edge* min_edge = pq.top();
-        pq.pop();
+        if (pq.empty()) {
+            throw std::invalid_argument("No MST can be built !");
+        }
 
-        Node* rep1 = uf.Find(min_edge->p1);
-        Node* rep2 = uf.Find(min_edge->p2);
+        edge_id_t min_edge = pq.top();
+        pq.pop();
 
-        if (rep1 != rep2) {
-            this->mst_graph.add_edge(min_edge);
-            this->mst_weight += min_edge->weight;
-            uf.Union(rep1, rep2);
+        if (uf.Union(csr.edges[min_edge].u, csr.edges[min_edge].v)) {
+            this->mst_graph.add_edge(this->initial_graph->get_edge(min_edge));
+            this->mst_weight += csr.edges[min_edge].weight;
         }
 
         k = uf.get_num_classes();
     }
+}
 
-    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
-    std::cout << "[OK]" << std::endl;
-    this->treatment_done();
+void KruskalAlgorithm::compute_mst_sort()
+{
+    /*!
+     * @brief Kruskal's algorithm where a flat copy of the edges is sorted once,
+     * then scanned until n-1 edges have been accepted
+     * 
+     */
 
-    std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
+    const CSRGraph& csr = this->initial_graph->get_csr();
+    int n = csr.n;
 
-    std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
-}
\ No newline at end of file
+    // edges are stored by id, hence equal weights remain sorted by id
+    std::vector<WeightedEdge> edges = csr.edges;
+    radix_sort_edges(edges);
+
+    FlatUnionFind uf = FlatUnionFind(n);
+
+    int accepted = 0;
+    for (int i = 0; i < csr.m && accepted < n-1; i ++) {
+        const WeightedEdge& e = edges[i];
+
+        if (uf.Union(e.u, e.v)) {
+            this->mst_graph.add_edge(this->initial_graph->get_edge(e.id));
+            this->mst_weight += e.weight;
+            accepted += 1;
+        }
+    }
+
+    if (accepted < n-1) {
+        throw std::invalid_argument("No MST can be built !");
+    }
+}
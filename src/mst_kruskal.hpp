@@ -2,14 +2,28 @@
 
 #include "mst_algorithm.hpp"
 #include "union_find.hpp"
+#include "radix_sort.hpp"
 
 #include <iostream>
 #include <queue>
+#include <stdexcept>
+
+enum class KruskalMode 
+{
+    PriorityQueue,  // pops edges one by one from a heap
+    Sort            // radix sorts a flat copy of the edges once
+};
 
 class KruskalAlgorithm : public MSTAlgorithm
 {
+private:
+    KruskalMode mode;
+
+    void compute_mst_priority_queue();
+    void compute_mst_sort();
+
 public:
-    KruskalAlgorithm(Graph* graph);
+    KruskalAlgorithm(Graph* graph, KruskalMode mode_ = KruskalMode::Sort);
 
     virtual void compute_mst();
-};
\ No newline at end of file
+};
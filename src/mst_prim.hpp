@@ -1,6 +1,7 @@
 #pragma once
 
 #include "mst_algorithm.hpp"
+#include "indexed_heap.hpp"
 
 #include <set>
 #include <cfloat>
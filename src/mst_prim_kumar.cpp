@@ -4,63 +4,96 @@
 #include <mpi.h>
 
 
-#define IS_NODE_ALLOCATED_TO_ME(nodeid) (nodeid >= node_id_min && nodeid < node_id_max)
-
-PrimKumarAlgorithm::PrimKumarAlgorithm(Graph* graph, int rank_, int world_size_) : MSTAlgorithm(graph) 
+PrimKumarAlgorithm::PrimKumarAlgorithm(GraphPartition* partition_, int num_threads_) : MSTAlgorithm(partition_->get_graph()) 
 {
     /*!
      * @brief Builds the MST "solver"
      * 
-     * @param graph The graph to use
-     * @param rank_ The rank of the processor (MPI-related)
-     * @param world_size_ The world size (MPI-related)
+     * @param partition_ The part of the graph held by this processor, whose rank 
+     * and world size are used (MPI-related)
+     * @param num_threads_ The number of threads of this processor, 0 meaning one 
+     * per hardware core, and more than one running the hybrid algorithm
      *
      */
      
-    this->rank = rank_;
-    this->world_size = world_size_;
+    this->partition = partition_;
+    this->rank = partition_->get_rank();
+    this->world_size = partition_->get_world_size();
+    this->num_threads = resolve_num_threads(num_threads_);
 }
 
 
 void PrimKumarAlgorithm::compute_mst() 
 {
     /*!
-     * @brief Computes the Minimum Spanning Tree of the initial graph using 
-     * Prim-Kumar's algorithm. More specifically, initialize a priority queue to 
-     * sort the edges by their weight. At each iteration, it adds the edge with 
-     * minimal weight to the MST and checks for new edges to discover. 
+     * @brief Computes the Minimum Spanning Tree of the graph distributed over 
+     * the processors using Prim-Kumar's algorithm. More specifically, each 
+     * processor keeps the best edge reaching each of its own nodes. At each 
+     * iteration, the lightest of these edges is elected over all processors, 
+     * and each processor updates the best edges of its nodes with the edges 
+     * of the new node.
+     * 
+     * @note Nodes are identified across processors by their labels. Each 
+     * processor only adds to its MST graph the edges it elected, but all of 
+     * them compute the total weight.
      * 
      */
 
+    this->mst_weight = 0.0;
 
-    int n_slaves = this->world_size;
-    int n_nodes = this->initial_graph->get_number_of_nodes();
-
-    int min_nodes_per_proc = n_nodes/(n_slaves);
-    int split_nodes = n_nodes % n_slaves;
+    std::chrono::steady_clock::time_point begin;
+    if(this->rank == 0){
+        if (this->num_threads > 1) {
+            std::cout << "Computing the MST using hybrid Prim-Kumar's algorithm with " << this->num_threads << " threads per processor...";
+        } else {
+            std::cout << "Computing the MST using Prim-Kumar's algorithm...";
+        }
+        begin = std::chrono::steady_clock::now();
+    }
 
-    int nodes_interval[2];
+    // number of nodes and first node of the tree, over all the processors
+    std::vector<Node*> owned_nodes = this->partition->get_owned_nodes();
 
-    nodes_interval[0] = this->rank*min_nodes_per_proc + (this->rank < split_nodes ? this->rank : split_nodes);  
-    nodes_interval[1] = nodes_interval[0] + min_nodes_per_proc + (this->rank < split_nodes);
+    int n_owned = owned_nodes.size();
+    int n;
+    MPI_Allreduce(&n_owned, &n, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
 
-    int node_id_min = nodes_interval[0];
-    int node_id_max = nodes_interval[1]; 
+    int min_label = owned_nodes.empty() ? std::numeric_limits<int>::max() : owned_nodes[0]->label;
+    int start_label;
+    MPI_Allreduce(&min_label, &start_label, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
 
-    struct {double d; int edge_id;} iter_res;
-    struct {double d; int edge_id;} reduction_res;
+    if (this->num_threads > 1) {
+        this->compute_mst_hybrid(n, start_label);
+    } else {
+        this->compute_mst_queue(n, start_label);
+    }
 
+    if(this->rank == 0){
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        std::cout << "[OK]" << std::endl;
+        this->treatment_done();
 
-    this->mst_weight = 0.0;
+        std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
 
-    std::chrono::steady_clock::time_point begin;
-    if(this->rank == 0){
-        std::cout << "Computing the MST using Prim-Kumar's algorithm...";
-        begin = std::chrono::steady_clock::now();
+        std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
     }
+}
 
-    int n = this->initial_graph->get_number_of_nodes();
-    //std::vector<Node*> nodes = this->initial_graph->get_nodes();
+void PrimKumarAlgorithm::compute_mst_queue(int n, int start_label)
+{
+    /*!
+     * @brief Prim-Kumar's algorithm where each processor keeps its candidate 
+     * edges in a priority queue. The lightest edge is elected by a non-blocking 
+     * reduction, and each processor updates its queue with the new edges 
+     * discovered from the previous node while the reduction is in flight.
+     * 
+     * @param n The number of nodes over all processors
+     * @param start_label The label of the first node of the tree
+     * 
+     */
+
+    struct {double d; int label;} iter_res;
+    struct {double d; int label;} reduction_res;
 
     auto cmp = [](const Edge* e1, const Edge* e2) 
         { 
@@ -79,132 +112,209 @@ void PrimKumarAlgorithm::compute_mst()
             }
         };
 
-    // initialization of the priority queue (ie set), best edge per vertex and beginning vertex
+    // initialization of the priority queue (ie set), best edge per owned vertex
     std::unordered_map<Node*, Edge*> min_edge;
     std::set<Edge*, decltype(cmp)> pq(cmp);
 
+    int new_label = start_label;
+    std::vector<Edge*> improving_edges;
+    MPI_Request request;
 
-    Node* current_node = this->initial_graph->get_node(0);
-
-
-
-
-    this->mst_graph.add_node(current_node); // just to have the source node in the MST
+    // filling the MST with new nodes until it forms a tree 
+    for (int n_visited = 1; n_visited < n; n_visited ++) {
 
-    std::unordered_set<Edge*> connected_edges = this->initial_graph->connected_edges(current_node);
+        // the new node is known here if it is owned, or is a neighbor of an owned node
+        Node* new_node = this->partition->get_node(new_label);
+        improving_edges.clear();
 
-    for (Edge* e : connected_edges) {
+        if (new_node != NULL) {
+            this->mst_graph.add_node(new_node);
 
-        Node* other_node = e->other_node(current_node);
-        if(IS_NODE_ALLOCATED_TO_ME(other_node->get_id())){
-            if (!this->mst_graph.has_node(other_node)) {
-                if (min_edge.find(other_node) != min_edge.end()) 
-                {
-                    if (*e < *min_edge.at(other_node)) {
-                        pq.erase(min_edge.at(other_node));
-                        min_edge.erase(other_node);
+            // we won't need the best edge for this node anymore
+            if (min_edge.find(new_node) != min_edge.end()) {
+                pq.erase(min_edge.at(new_node));
+                min_edge.erase(new_node);
+            }
 
-                        min_edge.insert(std::pair<Node*, Edge*>(other_node, e));
-                        pq.insert(e);
-                    }
+            // finding the owned nodes best edges to update, without touching the queue yet
+            for (Edge* e : this->initial_graph->connected_edges(new_node)) {
+                Node* other_node = e->other_node(new_node);
+                if (!this->partition->is_owned(other_node) || this->mst_graph.has_node(other_node)) {
+                    continue;
                 }
-                else 
-                {
-                    min_edge.insert(std::pair<Node*, Edge*>(other_node, e));
-                    pq.insert(e);
+
+                if (min_edge.find(other_node) == min_edge.end() || *e < *min_edge.at(other_node)) {
+                    improving_edges.push_back(e);
                 }
             }
-        } 
-    }
-
-    //std::printf("Proc %d, %d remaning items in queue\n", this->rank, pq.size());
-
-    // filling the MST with new nodes until it forms a tree 
-    while (this->mst_graph.get_number_of_nodes() < n) {
+        }
 
-        Edge* new_edge;
+        // the best local candidate is either in the queue, or one of the updated edges
+        Edge* candidate = pq.empty() ? NULL : *pq.begin();
+        for (Edge* e : improving_edges) {
+            if (candidate == NULL || cmp(e, candidate)) {
+                candidate = e;
+            }
+        }
 
-        if(!pq.empty()){
-            // adding the new edge and node to the MST and the visited nodes
-            Edge* new_edge = *pq.begin();
+        if (candidate != NULL) {
+            Node* candidate_node = this->mst_graph.has_node(candidate->p1) ? candidate->p2 : candidate->p1;
 
-            // We shall now send this to the root processor, so that it decides which edge is the best
-            iter_res.edge_id = new_edge->id;
-            iter_res.d = new_edge->weight;            
+            iter_res.d = candidate->weight;
+            iter_res.label = candidate_node->label;
         } else {
             iter_res.d = std::numeric_limits<double>::infinity();
+            iter_res.label = std::numeric_limits<int>::max();
         }
 
+        // We shall now send the best local candidate to every processor, so that 
+        // they agree on the best one, while updating the queue
+        MPI_Iallreduce(&iter_res, &reduction_res, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD, &request);
 
-        //std::printf("Proc %d, %d remaning items in queue\n", this->rank, pq.size());
-        MPI_Barrier(MPI_COMM_WORLD);
-        MPI_Allreduce(&iter_res, &reduction_res, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
-        MPI_Barrier(MPI_COMM_WORLD);
+        for (Edge* e : improving_edges) {
+            Node* other_node = e->other_node(new_node);
+
+            if (min_edge.find(other_node) != min_edge.end()) {
+                pq.erase(min_edge.at(other_node));
+                min_edge.erase(other_node);
+            }
 
+            min_edge.insert(std::pair<Node*, Edge*>(other_node, e));
+            pq.insert(e);
+        }
 
-        // This is the REAL new edge
-        new_edge = this->initial_graph->get_edge(reduction_res.edge_id);
+        MPI_Wait(&request, MPI_STATUS_IGNORE);
 
-        if(reduction_res.d == std::numeric_limits<double>::infinity()){
-            printf("ARRRHS\n");
-        } else {
-            //printf("Elected edge %d\n", reduction_res.edge_id);
+        if (reduction_res.d == std::numeric_limits<double>::infinity()) {
+            throw std::invalid_argument("No MST can be built !");
         }
 
-        Node* p1 = new_edge->p1;
-        Node* p2 = new_edge->p2;
-        Node* new_node = (this->mst_graph.has_node(p1)) ? p2 : p1;
+        // the processor owning the new node holds the elected edge
+        if (iter_res.label == reduction_res.label) {
+            this->mst_graph.add_edge(candidate);
+        }
 
-        this->mst_graph.add_edge(new_edge);
-        this->mst_weight += new_edge->weight;
+        this->mst_weight += reduction_res.d;
+        new_label = reduction_res.label;
+    }
 
+    // the last node of the tree
+    Node* last_node = this->partition->get_node(new_label);
+    if (n > 0 && last_node != NULL) {
+        this->mst_graph.add_node(last_node);
+    }
+}
 
+void PrimKumarAlgorithm::compute_mst_hybrid(int n, int start_label)
+{
+    /*!
+     * @brief Prim-Kumar's algorithm where each processor runs a pool of threads. 
+     * The best edge of each node is stored in flat arrays, the threads update 
+     * the best edges of distinct neighbors of the new node, then look for the 
+     * best candidate over their block of nodes. Only the best candidate of the 
+     * processor enters the reduction.
+     * 
+     * @param n The number of nodes over all processors
+     * @param start_label The label of the first node of the tree
+     * 
+     */
 
-        this->mst_graph.add_node(new_node);
-        
-        pq.erase(new_edge);
+    struct candidate_t {double d; int label;};
+    candidate_t iter_res;
+    candidate_t reduction_res;
 
-        if(IS_NODE_ALLOCATED_TO_ME(p1->get_id()) || IS_NODE_ALLOCATED_TO_ME(p2->get_id())){
-            // we won't need the best edge for this node anymore
-            min_edge.erase(new_node);
+    const double no_weight = std::numeric_limits<double>::infinity();
+    const int no_label = std::numeric_limits<int>::max();
 
-        }
+    // local identifiers of the nodes, which are owned or neighbors of owned nodes
+    const CSRGraph& csr = this->initial_graph->get_csr();
+    int n_local = csr.n;
 
+    std::unordered_map<node_label_t, node_id_t> local_ids;
+    std::vector<node_label_t> labels(n_local);
+    std::vector<char> owned(n_local);
 
-        // updating the external nodes best edges
-        connected_edges = this->initial_graph->connected_edges(new_node);
-            for (Edge* e : connected_edges) {
-                Node* other_node = e->other_node(new_node);
-                if(IS_NODE_ALLOCATED_TO_ME(other_node->get_id())){
-                    if (!this->mst_graph.has_node(other_node)) {
-                        if (min_edge.find(other_node) != min_edge.end()) 
-                        {
-                            if (*e < *min_edge.at(other_node)) {
-                                pq.erase(min_edge.at(other_node));
-                                min_edge.erase(other_node);
-
-                                min_edge.insert(std::pair<Node*, Edge*>(other_node, e));
-                                pq.insert(e);
-                            }
-                        }
-                        else 
-                        {
-                            min_edge.insert(std::pair<Node*, Edge*>(other_node, e));
-                            pq.insert(e);
-                        }
+    for (node_id_t u = 0; u < n_local; u ++) {
+        Node* node = this->initial_graph->get_node(u);
+        labels[u] = node->label;
+        owned[u] = this->partition->is_owned(node);
+        local_ids.insert(std::pair<node_label_t, node_id_t>(node->label, u));
+    }
+
+    std::vector<double> keys(n_local, no_weight);
+    std::vector<edge_id_t> best_edges(n_local, -1);
+    std::vector<char> in_tree(n_local, 0);
+
+    ThreadPool pool(this->num_threads);
+    std::vector<candidate_t> thread_best(pool.get_num_threads());
+
+    int new_label = start_label;
+
+    // filling the MST with new nodes until it forms a tree 
+    for (int n_visited = 1; n_visited <= n; n_visited ++) {
+
+        // the new node is known here if it is owned, or is a neighbor of an owned node
+        std::unordered_map<node_label_t, node_id_t>::iterator it = local_ids.find(new_label);
+
+        if (it != local_ids.end()) {
+            node_id_t v = it->second;
+            in_tree[v] = 1;
+            this->mst_graph.add_node(this->initial_graph->get_node(v));
+
+            // updating the owned nodes best edges, each slot leading to a distinct node
+            int first_slot = csr.offsets[v];
+            pool.run(csr.degree(v), [&](int, int begin, int end) {
+                for (int slot = first_slot + begin; slot < first_slot + end; slot ++) {
+                    node_id_t w = csr.targets[slot];
+                    if (!owned[w] || in_tree[w]) {
+                        continue;
+                    }
+
+                    double weight = csr.weights[slot];
+                    if (weight < keys[w] || (weight == keys[w] && csr.edge_ids[slot] < best_edges[w])) {
+                        keys[w] = weight;
+                        best_edges[w] = csr.edge_ids[slot];
                     }
                 }
+            });
+        }
+
+        if (n_visited == n) {
+            break;
+        }
+
+        // each thread looks for the best candidate over its block of nodes
+        pool.run(n_local, [&](int thread, int begin, int end) {
+            candidate_t best = {no_weight, no_label};
+            for (node_id_t u = begin; u < end; u ++) {
+                if (owned[u] && !in_tree[u] && (keys[u] < best.d || (keys[u] == best.d && labels[u] < best.label))) {
+                    best.d = keys[u];
+                    best.label = labels[u];
+                }
             }
-    }
-    
-    MPI_Barrier(MPI_COMM_WORLD);
-    if(this->rank == 0){
-        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
-        std::cout << "[OK]" << std::endl;
-        this->treatment_done();
+            thread_best[thread] = best;
+        });
 
-        std::cout << "Total weight of the MST: " << this->mst_weight << std::endl;
+        iter_res = thread_best[0];
+        for (const candidate_t& best : thread_best) {
+            if (best.d < iter_res.d || (best.d == iter_res.d && best.label < iter_res.label)) {
+                iter_res = best;
+            }
+        }
 
-        std::cout << "Time spent by the algorithm: " << std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count() << " µs" << std::endl;
+        MPI_Allreduce(&iter_res, &reduction_res, 1, MPI_DOUBLE_INT, MPI_MINLOC, MPI_COMM_WORLD);
+
+        if (reduction_res.d == no_weight) {
+            throw std::invalid_argument("No MST can be built !");
+        }
+
+        // the processor owning the new node holds the elected edge
+        if (iter_res.label == reduction_res.label) {
+            node_id_t w = local_ids.at(reduction_res.label);
+            this->mst_graph.add_edge(this->initial_graph->get_edge(best_edges[w]));
+        }
+
+        this->mst_weight += reduction_res.d;
+        new_label = reduction_res.label;
     }
 }
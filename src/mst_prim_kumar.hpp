@@ -1,4 +1,6 @@
 #include "mst_algorithm.hpp"
+#include "graph_partition.hpp"
+#include "thread_pool.hpp"
 
 #include <set>
 #include <cfloat>
@@ -8,14 +10,16 @@
 class PrimKumarAlgorithm : public MSTAlgorithm
 {
     private:
+        GraphPartition* partition;
         int world_size;
         int rank;
+        int num_threads;
 
-        void compute_mst_slave();
-        void compute_mst_master();
+        void compute_mst_queue(int n, int start_label);
+        void compute_mst_hybrid(int n, int start_label);
 
     public:
-        PrimKumarAlgorithm(Graph* graph, int rank_, int world_size_);
+        PrimKumarAlgorithm(GraphPartition* partition_, int num_threads_ = 1);
 
         virtual void compute_mst();
-};
\ No newline at end of file
+};
@@ -11,6 +11,7 @@ Node::Node(node_label_t label)
     
     this->label = label;
     this->p = NULL;
+    this->id = -1;
 }
 
 Node::Node(node_label_t label, Point* p)
@@ -25,6 +26,7 @@ Node::Node(node_label_t label, Point* p)
 
     this->label = label;
     this->p = p;
+    this->id = -1;
 }
 
 Point* Node::get_point()
@@ -112,7 +114,7 @@ double intracluster_variance(std::unordered_map<Node*, Node*> clusters)
         int cluster_size = members.at(rep).size();
 
         // secondly, we compute centers as in the M-step of kmeans 
-        Node* center = new Node(rep->label, new Point());
+        Node* center = new Node(rep->label, new Point(d));
 
         for (Node* member : members.at(rep)) {
             for (int j = 0; j < d; j ++) {
@@ -137,98 +139,94 @@ double intracluster_variance(std::unordered_map<Node*, Node*> clusters)
     return intracluster_variance;
 }
 
-double silhouette(std::unordered_map<Node*, Node*> clusters)
+namespace
+{
+
+int gather_clusters(std::unordered_map<Node*, Node*>& clusters, std::vector<double>& coords, std::vector<int>& labels, int& d)
 {
     /*!
-     * @brief Computes the silhouette of the clusters given in argument
+     * @brief Numbers the nodes and their clusters, and gathers the coordinates
+     * of the nodes contiguously
      *
      * @param clusters A mapping between nodes and their representatives 
      * in clusters
+     * @param coords The row-major coordinates of the nodes
+     * @param labels The index of the cluster of each node
+     * @param d The dimension of the points of the nodes
      * 
-     * @return The silhouette of these clusters
+     * @return The number of clusters
      */
 
     int n = clusters.size(); // number of nodes
 
-	double silhouette = 0.0;
-
-    // firstly, we compute the clusters in the reverse mode, that is, 
-    // we take for each representative, all its members
-    std::unordered_set<Node*> representatives;
-    std::unordered_map<Node*, int> clusters_size;
-    std::unordered_map<Node*, std::unordered_set<Node*> > members;
-    std::unordered_set<Node*> nodes;
+    std::vector<Node*> nodes;
+    std::unordered_map<Node*, int> cluster_index;
 
+    labels.clear();
     for (auto kv : clusters) {
-        Node* node = kv.first;
         Node* rep = kv.second;
 
-        nodes.insert(node);
-
-        representatives.insert(rep);
-        if (clusters_size.find(rep) == clusters_size.end()) {
-            clusters_size.insert(std::pair<Node*, int>(rep, 0));
-        }
-        clusters_size.at(rep) += 1;
-        
-        if (members.find(rep) == members.end()) {
-            members.insert(std::pair<Node*, std::unordered_set<Node*> >(rep, std::unordered_set<Node*>()));
+        if (cluster_index.find(rep) == cluster_index.end()) {
+            int index = cluster_index.size();
+            cluster_index.insert(std::pair<Node*, int>(rep, index));
         }
 
-        members.at(rep).insert(node);
+        nodes.push_back(kv.first);
+        labels.push_back(cluster_index.at(rep));
     }
 
-    int nb_clusters = representatives.size();
+    d = (n > 0) ? nodes[0]->get_point()->get_dim() : 0;
 
-	// we compute a and b which are respectively the 
-	// average distance to points of the same cluster 
-	// and min of average distances to foreign clusters
-    std::unordered_map<Node*, double> a;
-    std::unordered_map<Node*, double> b;
-    std::unordered_map<Node*, double> s;
-
-    for (Node* node : nodes) {
-        a.insert(std::pair<Node*, double>(node, 0.0));
-        b.insert(std::pair<Node*, double>(node, 0.0));
-        s.insert(std::pair<Node*, double>(node, 0.0));
+    coords.resize((size_t) n * d);
+    for (int i = 0; i < n; i ++) {
+        Point* p = nodes[i]->get_point();
+        assert(p != NULL && p->get_dim() == d && "Nodes must hold points of the same dimension");
+        std::copy(p->coords, p->coords + d, coords.begin() + (size_t) i*d);
     }
 
-	for (Node* node : nodes){
-        std::unordered_map<Node*, double> dist_to_clusters;
-        for (Node* rep : representatives) {
-            dist_to_clusters.insert(std::pair<Node*, double>(rep, 0.0));
-        }
+    return cluster_index.size();
+}
 
-        for (Node* other_node : nodes) {
-            if (other_node != node) {
-                Node* other_node_cluster = clusters.at(other_node);
+}
 
-                dist_to_clusters.at(other_node_cluster) += std::sqrt(node->dist(other_node));
-            }
-        }
+double silhouette(std::unordered_map<Node*, Node*> clusters)
+{
+    /*!
+     * @brief Computes the silhouette of the clusters given in argument
+     *
+     * @param clusters A mapping between nodes and their representatives 
+     * in clusters
+     * 
+     * @return The silhouette of these clusters
+     */
 
-        double minDist = DBL_MAX;
-        for (Node* rep : representatives) {
-            dist_to_clusters.at(rep) /= clusters_size.at(rep);
+    std::vector<double> coords;
+    std::vector<int> labels;
+    int d;
+    int nb_clusters = gather_clusters(clusters, coords, labels, d);
 
-            if (rep != clusters.at(node) && dist_to_clusters.at(rep) < minDist) {
-                minDist = dist_to_clusters.at(rep);
-            }
-        }
+    return silhouette_score(coords.data(), labels.data(), labels.size(), d, nb_clusters);
+}
 
-        a.at(node) = dist_to_clusters.at(clusters.at(node));
-        if (minDist < DBL_MAX) {
-            b.at(node) = minDist;
-        }
-        s.at(node) = (b.at(node) - a.at(node)) / (std::max(a.at(node), b.at(node)));
-	}
+SilhouetteEstimate sampled_silhouette(std::unordered_map<Node*, Node*> clusters, int sample_size)
+{
+    /*!
+     * @brief Estimates the silhouette of the clusters given in argument from
+     * a stratified sample of the nodes
+     *
+     * @param clusters A mapping between nodes and their representatives 
+     * in clusters
+     * @param sample_size The approximate number of nodes to sample
+     * 
+     * @return The estimated silhouette, with its 95% confidence interval
+     */
 
-    for (Node* node : nodes) {
-        silhouette += s.at(node);
-    }
-	silhouette /= n;
+    std::vector<double> coords;
+    std::vector<int> labels;
+    int d;
+    int nb_clusters = gather_clusters(clusters, coords, labels, d);
 
-	return silhouette;
+    return sampled_silhouette_score(coords.data(), labels.data(), labels.size(), d, nb_clusters, sample_size);
 }
 
 void Node::set_id(node_id_t id_){
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "point.hpp"
+#include "silhouette.hpp"
 
 #include <vector>
 #include <cmath>
@@ -18,7 +19,7 @@ class Node{
      * 
      */
     private:
-        node_id_t id;
+        node_id_t id; // in the first graph the node is added to, -1 before
 
     protected:
         Point* p;
@@ -39,3 +40,4 @@ class Node{
 
 double intracluster_variance(std::unordered_map<Node*, Node*> clusters);
 double silhouette(std::unordered_map<Node*, Node*> clusters);
+SilhouetteEstimate sampled_silhouette(std::unordered_map<Node*, Node*> clusters, int sample_size);
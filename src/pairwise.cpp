@@ -0,0 +1,367 @@
+#include "pairwise.hpp"
+#include "dimension.hpp"
+#include "distance.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// relative threshold under which a distance is recomputed directly
+#define PAIRWISE_CANCELLATION 1e-7
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PAIRWISE_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace
+{
+
+/*
+ * Each kernel computes the squared distances between PAIRWISE_TILE_SIZE rows 
+ * and PAIRWISE_TILE_SIZE columns, given their squared norms. The rows are 
+ * row-major and the columns are packed coordinate by coordinate, the k-th 
+ * coordinate of the j-th column being at index k*PAIRWISE_TILE_SIZE+j, all 
+ * being padded with zeros. The distance between row i and column j is written 
+ * at index i*PAIRWISE_TILE_SIZE+j. Dot products are computed by micro-tiles of 
+ * a few rows and columns, whose accumulators stay in registers. Rows holding 
+ * a distance too small for the expansion to be accurate are flagged in close.
+ */
+
+template <int D>
+void tile_distances_scalar(const double* x_rows, const double* x_norms, const double* packed_cols, const double* col_norms, int d, double* dists, int* close)
+{
+    const int dim = (D > 0) ? D : d;
+    const int T = PAIRWISE_TILE_SIZE;
+
+    for (int i = 0; i < T; i += 2) {
+        for (int j = 0; j < T; j += 2) {
+            double acc00 = 0.0, acc01 = 0.0, acc10 = 0.0, acc11 = 0.0;
+
+            for (int k = 0; k < dim; k ++) {
+                double x0 = x_rows[(size_t) i*dim + k];
+                double x1 = x_rows[(size_t) (i+1)*dim + k];
+                double y0 = packed_cols[(size_t) k*T + j];
+                double y1 = packed_cols[(size_t) k*T + j+1];
+
+                acc00 += x0*y0;
+                acc01 += x0*y1;
+                acc10 += x1*y0;
+                acc11 += x1*y1;
+            }
+
+            double acc[2][2] = {{acc00, acc01}, {acc10, acc11}};
+            for (int r = 0; r < 2; r ++) {
+                for (int c = 0; c < 2; c ++) {
+                    double norms = x_norms[i+r] + col_norms[j+c];
+                    double dist = norms - 2*acc[r][c];
+
+                    dists[(size_t) (i+r)*T + j+c] = std::max(dist, 0.0);
+                    close[i+r] |= (dist <= PAIRWISE_CANCELLATION * norms);
+                }
+            }
+        }
+    }
+}
+
+#ifdef PAIRWISE_X86_KERNELS
+
+template <int D>
+__attribute__((target("avx2,fma")))
+void tile_distances_avx2(const double* x_rows, const double* x_norms, const double* packed_cols, const double* col_norms, int d, double* dists, int* close)
+{
+    /*!
+     * @brief Micro-tiles of 4 rows x 8 columns, held in 8 registers
+     *
+     */
+
+    const int dim = (D > 0) ? D : d;
+    const int T = PAIRWISE_TILE_SIZE;
+
+    for (int i = 0; i < T; i += 4) {
+        const double* x = x_rows + (size_t) i*dim;
+
+        for (int j = 0; j < T; j += 8) {
+            __m256d acc[4][2];
+            for (int r = 0; r < 4; r ++) {
+                acc[r][0] = _mm256_setzero_pd();
+                acc[r][1] = _mm256_setzero_pd();
+            }
+
+            for (int k = 0; k < dim; k ++) {
+                __m256d y0 = _mm256_loadu_pd(packed_cols + (size_t) k*T + j);
+                __m256d y1 = _mm256_loadu_pd(packed_cols + (size_t) k*T + j + 4);
+
+                for (int r = 0; r < 4; r ++) {
+                    __m256d xr = _mm256_broadcast_sd(x + (size_t) r*dim + k);
+                    acc[r][0] = _mm256_fmadd_pd(xr, y0, acc[r][0]);
+                    acc[r][1] = _mm256_fmadd_pd(xr, y1, acc[r][1]);
+                }
+            }
+
+            // ||x||^2 + ||y||^2 - 2 x.y, which rounding errors may make negative
+            __m256d minus_two = _mm256_set1_pd(-2.0);
+            __m256d zero = _mm256_setzero_pd();
+            __m256d y_norm0 = _mm256_loadu_pd(col_norms + j);
+            __m256d y_norm1 = _mm256_loadu_pd(col_norms + j + 4);
+
+            __m256d cancellation = _mm256_set1_pd(PAIRWISE_CANCELLATION);
+
+            for (int r = 0; r < 4; r ++) {
+                __m256d x_norm = _mm256_broadcast_sd(x_norms + i + r);
+                __m256d norms0 = _mm256_add_pd(x_norm, y_norm0);
+                __m256d norms1 = _mm256_add_pd(x_norm, y_norm1);
+                __m256d dist0 = _mm256_fmadd_pd(minus_two, acc[r][0], norms0);
+                __m256d dist1 = _mm256_fmadd_pd(minus_two, acc[r][1], norms1);
+                _mm256_storeu_pd(dists + (size_t) (i+r)*T + j, _mm256_max_pd(dist0, zero));
+                _mm256_storeu_pd(dists + (size_t) (i+r)*T + j + 4, _mm256_max_pd(dist1, zero));
+
+                __m256d close0 = _mm256_cmp_pd(dist0, _mm256_mul_pd(cancellation, norms0), _CMP_LE_OQ);
+                __m256d close1 = _mm256_cmp_pd(dist1, _mm256_mul_pd(cancellation, norms1), _CMP_LE_OQ);
+                close[i+r] |= _mm256_movemask_pd(_mm256_or_pd(close0, close1));
+            }
+        }
+    }
+}
+
+template <int D>
+__attribute__((target("avx512f")))
+void tile_distances_avx512(const double* x_rows, const double* x_norms, const double* packed_cols, const double* col_norms, int d, double* dists, int* close)
+{
+    /*!
+     * @brief Micro-tiles of 8 rows x 16 columns, held in 16 registers
+     *
+     */
+
+    const int dim = (D > 0) ? D : d;
+    const int T = PAIRWISE_TILE_SIZE;
+
+    for (int i = 0; i < T; i += 8) {
+        const double* x = x_rows + (size_t) i*dim;
+
+        for (int j = 0; j < T; j += 16) {
+            __m512d acc[8][2];
+            for (int r = 0; r < 8; r ++) {
+                acc[r][0] = _mm512_setzero_pd();
+                acc[r][1] = _mm512_setzero_pd();
+            }
+
+            for (int k = 0; k < dim; k ++) {
+                __m512d y0 = _mm512_loadu_pd(packed_cols + (size_t) k*T + j);
+                __m512d y1 = _mm512_loadu_pd(packed_cols + (size_t) k*T + j + 8);
+
+                for (int r = 0; r < 8; r ++) {
+                    __m512d xr = _mm512_set1_pd(x[(size_t) r*dim + k]);
+                    acc[r][0] = _mm512_fmadd_pd(xr, y0, acc[r][0]);
+                    acc[r][1] = _mm512_fmadd_pd(xr, y1, acc[r][1]);
+                }
+            }
+
+            // ||x||^2 + ||y||^2 - 2 x.y, which rounding errors may make negative
+            __m512d minus_two = _mm512_set1_pd(-2.0);
+            __m512d zero = _mm512_setzero_pd();
+            __m512d y_norm0 = _mm512_loadu_pd(col_norms + j);
+            __m512d y_norm1 = _mm512_loadu_pd(col_norms + j + 8);
+
+            __m512d cancellation = _mm512_set1_pd(PAIRWISE_CANCELLATION);
+
+            for (int r = 0; r < 8; r ++) {
+                __m512d x_norm = _mm512_set1_pd(x_norms[i + r]);
+                __m512d norms0 = _mm512_add_pd(x_norm, y_norm0);
+                __m512d norms1 = _mm512_add_pd(x_norm, y_norm1);
+                __m512d dist0 = _mm512_fmadd_pd(minus_two, acc[r][0], norms0);
+                __m512d dist1 = _mm512_fmadd_pd(minus_two, acc[r][1], norms1);
+                _mm512_storeu_pd(dists + (size_t) (i+r)*T + j, _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(dist0, zero, _CMP_GT_OQ), dist0));
+                _mm512_storeu_pd(dists + (size_t) (i+r)*T + j + 8, _mm512_maskz_mov_pd(_mm512_cmp_pd_mask(dist1, zero, _CMP_GT_OQ), dist1));
+
+                __mmask8 close0 = _mm512_cmp_pd_mask(dist0, _mm512_mul_pd(cancellation, norms0), _CMP_LE_OQ);
+                __mmask8 close1 = _mm512_cmp_pd_mask(dist1, _mm512_mul_pd(cancellation, norms1), _CMP_LE_OQ);
+                close[i+r] |= (close0 | close1);
+            }
+        }
+    }
+}
+
+#endif
+
+typedef void (*TileKernel)(const double*, const double*, const double*, const double*, int, double*, int*);
+
+TileKernel select_tile_kernel(int d)
+{
+    /*!
+     * @brief Picks the kernel of the widest instruction set supported by the 
+     * running processor, specialized for the dimension \p d when it is common
+     *
+     */
+
+#ifdef PAIRWISE_X86_KERNELS
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) {
+        return dispatch_dimension(d, [](auto D) { return (TileKernel) tile_distances_avx512<decltype(D)::value>; });
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return dispatch_dimension(d, [](auto D) { return (TileKernel) tile_distances_avx2<decltype(D)::value>; });
+    }
+#endif
+
+    return dispatch_dimension(d, [](auto D) { return (TileKernel) tile_distances_scalar<decltype(D)::value>; });
+}
+
+void center_rows(const double* x, int n, int d, const std::vector<double>& mean, std::vector<double>& centered, std::vector<double>& norms)
+{
+    /*!
+     * @brief Copies the rows minus the \p mean, and computes their squared norms
+     *
+     */
+
+    centered.resize((size_t) n * d);
+    norms.resize(n);
+
+    for (int i = 0; i < n; i ++) {
+        double norm = 0.0;
+        for (int k = 0; k < d; k ++) {
+            double value = x[(size_t) i*d + k] - mean[k];
+            centered[(size_t) i*d + k] = value;
+            norm += value*value;
+        }
+        norms[i] = norm;
+    }
+}
+
+void tiled_squared_distances(const double* x, int n, const double* y, int m, int d, bool symmetric, const DistanceTileConsumer& consumer)
+{
+    /*!
+     * @brief Shared implementation of both versions of pairwise_squared_distances
+     *
+     */
+
+    const int T = PAIRWISE_TILE_SIZE;
+
+    // the expansion loses precision far from the origin, hence points are centered
+    std::vector<double> mean(d, 0.0);
+    for (int i = 0; i < n; i ++) {
+        for (int k = 0; k < d; k ++) {
+            mean[k] += x[(size_t) i*d + k];
+        }
+    }
+    for (int k = 0; k < d; k ++) {
+        mean[k] /= std::max(n, 1);
+    }
+
+    std::vector<double> x_centered, x_norms, y_centered, y_norms;
+    center_rows(x, n, d, mean, x_centered, x_norms);
+    if (symmetric) {
+        y = x;
+    } else {
+        center_rows(y, m, d, mean, y_centered, y_norms);
+    }
+
+    const std::vector<double>& y_rows = symmetric ? x_centered : y_centered;
+    const std::vector<double>& y_sq_norms = symmetric ? x_norms : y_norms;
+
+    // the columns of every tile are packed once, coordinate by coordinate
+    int nb_col_tiles = (m + T - 1) / T;
+    std::vector<double> packed((size_t) nb_col_tiles * d * T, 0.0);
+    std::vector<double> col_norms((size_t) nb_col_tiles * T, 0.0);
+    for (int j = 0; j < m; j ++) {
+        double* tile_cols = packed.data() + (size_t) (j / T) * d * T;
+        for (int k = 0; k < d; k ++) {
+            tile_cols[(size_t) k*T + j % T] = y_rows[(size_t) j*d + k];
+        }
+        col_norms[j] = y_sq_norms[j];
+    }
+
+    TileKernel tile_kernel = select_tile_kernel(d);
+
+    std::vector<double> x_rows((size_t) T * d);
+    std::vector<double> row_norms(T);
+    std::vector<double> tile((size_t) T * T);
+    std::vector<int> close(T);
+
+    for (int row_begin = 0; row_begin < n; row_begin += T) {
+        int row_end = std::min(row_begin + T, n);
+
+        std::fill(x_rows.begin(), x_rows.end(), 0.0);
+        std::fill(row_norms.begin(), row_norms.end(), 0.0);
+        std::copy(x_centered.begin() + (size_t) row_begin * d, x_centered.begin() + (size_t) row_end * d, x_rows.begin());
+        std::copy(x_norms.begin() + row_begin, x_norms.begin() + row_end, row_norms.begin());
+
+        int first_col_tile = symmetric ? row_begin / T : 0;
+        for (int col_tile = first_col_tile; col_tile < nb_col_tiles; col_tile ++) {
+            int col_begin = col_tile * T;
+            int col_end = std::min(col_begin + T, m);
+
+            std::fill(close.begin(), close.end(), 0);
+            tile_kernel(x_rows.data(), row_norms.data(), packed.data() + (size_t) col_tile * d * T, 
+                        col_norms.data() + col_begin, d, tile.data(), close.data());
+
+            // the expansion suffers from cancellation when points are close 
+            // relative to their norms, such distances are computed directly
+            for (int i = row_begin; i < row_end; i ++) {
+                if (!close[i - row_begin]) {
+                    continue;
+                }
+
+                double* dist = tile.data() + (size_t) (i - row_begin) * T;
+                for (int j = col_begin; j < col_end; j ++) {
+                    if (dist[j - col_begin] <= PAIRWISE_CANCELLATION * (x_norms[i] + col_norms[j])) {
+                        dist[j - col_begin] = squared_distance(x + (size_t) i*d, y + (size_t) j*d, d);
+                    }
+                }
+            }
+
+            consumer(row_begin, row_end, col_begin, col_end, tile.data());
+        }
+    }
+}
+
+}
+
+void pairwise_squared_distances(const double* x, int n, const double* y, int m, int d, const DistanceTileConsumer& consumer)
+{
+    /*!
+     * @brief Computes the squared Euclidean distances between the rows of two
+     * sets of points, tile by tile, using ||x-y||^2 = ||x||^2 + ||y||^2 - 2 x.y
+     * where the dot products are computed by a cache-blocked kernel. Each tile
+     * is handed to \p consumer and then overwritten, so that the n x m matrix
+     * is never stored.
+     *
+     * @param x The row-major coordinates of the \p n first points
+     * @param n The number of first points
+     * @param y The row-major coordinates of the \p m second points
+     * @param m The number of second points
+     * @param d The dimension of the points
+     * @param consumer Called as consumer(row_begin, row_end, col_begin, col_end, tile)
+     * for each tile, where the squared distance between x[i] and y[j] is at index
+     * (i-row_begin)*PAIRWISE_TILE_SIZE + (j-col_begin) of the tile
+     *
+     * @note Tiles are visited row by row, and from left to right within a row.
+     * Distances which are small relative to the norms of the points, where the
+     * expansion loses its precision, are computed directly, so that duplicated
+     * points are at distance zero.
+     *
+     */
+
+    tiled_squared_distances(x, n, y, m, d, false, consumer);
+}
+
+void pairwise_squared_distances(const double* x, int n, int d, const DistanceTileConsumer& consumer)
+{
+    /*!
+     * @brief Computes the squared Euclidean distances between all the pairs of
+     * rows of a set of points, as the other version does, but only visiting the
+     * tiles which intersect the upper triangle j >= i
+     *
+     * @param x The row-major coordinates of the \p n points
+     * @param n The number of points
+     * @param d The dimension of the points
+     * @param consumer Called on each tile, see the other version. Tiles on the
+     * diagonal also hold pairs with j < i, which the consumer must skip if each
+     * pair must be seen once.
+     *
+     */
+
+    tiled_squared_distances(x, n, NULL, n, d, true, consumer);
+}
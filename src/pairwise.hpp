@@ -0,0 +1,10 @@
+#pragma once
+
+#include <functional>
+
+#define PAIRWISE_TILE_SIZE 128
+
+typedef std::function<void(int row_begin, int row_end, int col_begin, int col_end, const double* tile)> DistanceTileConsumer;
+
+void pairwise_squared_distances(const double* x, int n, const double* y, int m, int d, const DistanceTileConsumer& consumer);
+void pairwise_squared_distances(const double* x, int n, int d, const DistanceTileConsumer& consumer);
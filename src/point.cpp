@@ -1,4 +1,16 @@
 #include "point.hpp"
+#include "distance.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 int Point::d;
 
@@ -9,10 +21,45 @@ Point::Point()
      * 
      */
 
+    this->dim = d;
+    this->owns_coords = true;
     this->coords = new double [d] ();
     this->label = 0;
 }
 
+Point::Point(int dim_)
+{
+    /*!
+     * @brief Constructor of a Point of a given dimension, whose coordinates 
+     * are set to zero
+     * 
+     * @param dim_ The dimension of the Point
+     * 
+     */
+
+    this->dim = dim_;
+    this->owns_coords = true;
+    this->coords = new double [dim_] ();
+    this->label = 0;
+}
+
+Point::Point(double* coords_, int dim_)
+{
+    /*!
+     * @brief Constructor of a Point viewing coordinates stored elsewhere, 
+     * typically a row of a PointSet, which must outlive the Point
+     * 
+     * @param coords_ The \p dim_ coordinates of the Point
+     * @param dim_ The dimension of the Point
+     * 
+     */
+
+    this->dim = dim_;
+    this->owns_coords = false;
+    this->coords = coords_;
+    this->label = 0;
+}
+
 Point::~Point()
 {
     /*!
@@ -20,19 +67,21 @@ Point::~Point()
      * 
      */
 
-    delete[] this->coords;
+    if (this->owns_coords) {
+        delete[] this->coords;
+    }
 }
 
 int Point::get_dim()
 {
     /*!
-     * @brief Gives the shared dimension between all the points
+     * @brief Gives the dimension of the point
      * 
-     * @return The dimension \p d of all the points
+     * @return The dimension of the point
      * 
      */
 
-    return this->d;
+    return this->dim;
 }
 
 void Point::print()
@@ -42,7 +91,7 @@ void Point::print()
      * 
      */
 
-    for (int i = 0; i < d; i ++) {
+    for (int i = 0; i < this->dim; i ++) {
         std::cout << coords[i] << std::endl;
     }
     std::cout << "\n" << std::endl;
@@ -59,51 +108,205 @@ double Point::distance(Point* other)
      * @return The distance between this point and the \p other 
      */
 
-    double dist = 0.0;
-    for (int i = 0; i < d; i ++) {
-        dist += std::pow(coords[i] - other->coords[i], 2);
+    return std::sqrt(this->squared_distance(other));
+}
+
+double Point::squared_distance(Point* other)
+{
+    /*!
+     * @brief Evaluates the squared distance between two instances of the class 
+     * Point, which avoids the square root when distances are only compared
+     * 
+     * @param other Another Point of the same dimension
+     * 
+     * @return The squared distance between this point and the \p other 
+     */
+
+    return ::squared_distance(this->coords, other->coords, this->dim);
+}
+
+std::vector<double> Point::read_coords_from_file(std::string file_path, int& n, int& d, int num_threads)
+{
+    /*!
+     * @brief Parses a file of points, one per row with coordinates separated by 
+     * spaces, into a contiguous row-major buffer. The file is memory-mapped and 
+     * split into chunks on row boundaries, which are parsed in parallel.
+     * 
+     * @param file_path the path to the file to get data from
+     * @param n the number of points read
+     * @param d the dimension of the points, that is the number of values of the first row
+     * @param num_threads the number of threads, 0 meaning one per hardware core
+     * 
+     * @return The coordinates, the j-th coordinate of the i-th point being at index i*d+j
+     */
+
+    int fd = open(file_path.c_str(), O_RDONLY);
+    assert(fd >= 0 && "No such file");
+
+    struct stat st;
+    fstat(fd, &st);
+    size_t size = st.st_size;
+
+    n = 0;
+    d = 0;
+    std::vector<double> coords;
+
+    if (size == 0) {
+        close(fd);
+        return coords;
     }
-    dist = std::sqrt(dist);
 
-    return dist;
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    assert(data != MAP_FAILED && "Cannot map file");
+
+    const char* text = static_cast<const char*>(data);
+    const char* text_end = text + size;
+
+    // the dimension is the number of values of the first row
+    const char* c = text;
+    while (c < text_end && *c != '\n') {
+        while (c < text_end && (*c == ' ' || *c == '\t' || *c == '\r')) {
+            c ++;
+        }
+        if (c < text_end && *c != '\n') {
+            d += 1;
+            while (c < text_end && !std::isspace((unsigned char) *c)) {
+                c ++;
+            }
+        }
+    }
+
+    // chunks start right after a newline
+    num_threads = resolve_num_threads(num_threads);
+    std::vector<const char*> chunks(num_threads+1, text_end);
+    chunks[0] = text;
+    for (int t = 1; t < num_threads; t ++) {
+        const char* boundary = std::max(text + size * t / num_threads, chunks[t-1]);
+        while (boundary > text && boundary < text_end && *(boundary-1) != '\n') {
+            boundary ++;
+        }
+        chunks[t] = boundary;
+    }
+
+    auto is_blank = [](const char* begin, const char* end) {
+        for (const char* p = begin; p < end; p ++) {
+            if (!std::isspace((unsigned char) *p)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    // counting the rows of each chunk, blank rows being skipped
+    ThreadPool pool(num_threads);
+    std::vector<int> rows(num_threads+1, 0);
+    pool.run(num_threads, [&](int, int begin, int end) {
+        for (int t = begin; t < end; t ++) {
+            const char* row = chunks[t];
+            while (row < chunks[t+1]) {
+                const char* row_end = std::find(row, chunks[t+1], '\n');
+                rows[t+1] += !is_blank(row, row_end);
+                row = row_end + (row_end < chunks[t+1]);
+            }
+        }
+    });
+
+    for (int t = 0; t < num_threads; t ++) {
+        rows[t+1] += rows[t];
+    }
+
+    n = rows[num_threads];
+    coords.resize((size_t) n * d);
+
+    // parsing the rows of each chunk at their final place
+    std::atomic<bool> malformed(false);
+    pool.run(num_threads, [&](int, int begin, int end) {
+        for (int t = begin; t < end; t ++) {
+            double* x = coords.data() + (size_t) rows[t] * d;
+            const char* row = chunks[t];
+
+            while (row < chunks[t+1]) {
+                const char* row_end = std::find(row, chunks[t+1], '\n');
+                if (is_blank(row, row_end)) {
+                    row = row_end + (row_end < chunks[t+1]);
+                    continue;
+                }
+
+                const char* p = row;
+                for (int j = 0; j < d; j ++) {
+                    while (p < row_end && (*p == ' ' || *p == '\t')) {
+                        p ++;
+                    }
+
+                    std::from_chars_result result = std::from_chars(p, row_end, x[j]);
+                    if (result.ec != std::errc()) {
+                        malformed = true;
+                        return;
+                    }
+                    p = result.ptr;
+                }
+
+                if (!is_blank(p, row_end)) {
+                    malformed = true;
+                    return;
+                }
+
+                x += d;
+                row = row_end + (row_end < chunks[t+1]);
+            }
+        }
+    });
+
+    munmap(data, size);
+    close(fd);
+
+    if (malformed) {
+        throw std::invalid_argument("Malformed row in " + file_path);
+    }
+
+    return coords;
 }
 
-std::vector<Point*> Point::read_points_from_file(std::string file_path, int d) 
+std::vector<Point*> Point::read_points_from_file(std::string file_path)
 {
     /*!
      * @brief Builds a vector of points from a file where data is correctly
-     * formatted (double spaced with " ")
+     * formatted (double spaced with " "), and sets the dimension of the points
+     * to the number of values of its first row
      * 
      * @param file_path the path to the file to get data from
-     * @param d the dimension of the points
      * 
      * @return A vector of pointers to the created points
      */
 
-    std::vector<Point*> points;
+    int n, d;
+    std::vector<double> coords = Point::read_coords_from_file(file_path, n, d);
 
-    std::ifstream is(file_path);
-    assert(("No such file", is.is_open()));
+    Point::d = d;
 
-    std::string line;
-
-	// while not at the end of the file
-	while(is.peek() != EOF)
-	{
-		// read new points
-        Point* p = new Point();
+    std::vector<Point*> points(n);
+    for (int i = 0; i < n; i ++) {
+        points[i] = new Point(d);
+        std::copy(coords.begin() + (size_t) i*d, coords.begin() + (size_t) (i+1)*d, points[i]->coords);
+    }
 
-		for(int m = 0; m < d; m++)
-		{
-			is >> p->coords[m];
-		}
+    return points;
+}
 
-        points.push_back(p);
+std::vector<Point*> Point::read_points_from_file(std::string file_path, int d) 
+{
+    /*!
+     * @brief Builds a vector of points from a file where data is correctly
+     * formatted (double spaced with " ")
+     * 
+     * @param file_path the path to the file to get data from
+     * @param d the dimension of the points
+     * 
+     * @return A vector of pointers to the created points
+     */
 
-		// new line
-		is.get();
-	}
-    points.pop_back(); // last line makes an empty point otherwise
+    std::vector<Point*> points = Point::read_points_from_file(file_path);
+    assert((points.empty() || Point::d == d) && "Unexpected dimension");
 
     return points;
-}
\ No newline at end of file
+}
@@ -10,10 +10,17 @@
 class Point
 {
     /*!
-     * @class Describes a Point with static dimension
+     * @class Describes a Point, which either owns its coordinates or views
+     * the coordinates of a PointSet. Default-constructed points take the
+     * static dimension \p d
      * 
      */
 
+    private:
+
+        int dim;
+        bool owns_coords;
+
     public:
 
         static int d;
@@ -21,12 +28,17 @@ class Point
         int label; // for k-means
 
         Point();
+        Point(int dim_);
+        Point(double* coords_, int dim_);
         ~Point();
 
         int get_dim();
         void print();
         double distance(Point* other);
+        double squared_distance(Point* other);
 
+        static std::vector<double> read_coords_from_file(std::string file_path, int& n, int& d, int num_threads = 0);
+        static std::vector<Point*> read_points_from_file(std::string file_path);
         static std::vector<Point*> read_points_from_file(std::string file_path, int d);
 
 };
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "point_set.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+PointSet::PointSet(int n_, int d_)
+{
+    /*!
+     * @brief Builds a set of \p n_ points of dimension \p d_, whose
+     * coordinates are set to zero
+     *
+     * @param n_ The number of points
+     * @param d_ The dimension of the points
+     *
+     */
+
+    this->n = n_;
+    this->d = d_;
+
+    size_t size = std::max((size_t) n_ * d_, (size_t) 1) * sizeof(double);
+    void* buffer = NULL;
+    if (posix_memalign(&buffer, POINT_SET_ALIGNMENT, size) != 0) {
+        throw std::bad_alloc();
+    }
+
+    this->data = static_cast<double*>(buffer);
+    std::fill(this->data, this->data + (size_t) n_ * d_, 0.0);
+}
+
+PointSet::PointSet(const std::vector<double>& coords, int n_, int d_) : PointSet(n_, d_)
+{
+    /*!
+     * @brief Builds a set of points from their row-major coordinates
+     *
+     * @param coords The coordinates, the j-th coordinate of the i-th point
+     * being at index i*d_+j
+     * @param n_ The number of points
+     * @param d_ The dimension of the points
+     *
+     */
+
+    assert(coords.size() == (size_t) n_ * d_ && "Unexpected number of coordinates");
+
+    std::copy(coords.begin(), coords.end(), this->data);
+}
+
+PointSet::~PointSet()
+{
+    /*!
+     * @brief Destructor of a PointSet, the Points viewing it become invalid
+     *
+     */
+
+    free(this->data);
+}
+
+int PointSet::size() const
+{
+    /*!
+     * @brief Returns the number of points of the set
+     *
+     * @return The number of points
+     *
+     */
+
+    return this->n;
+}
+
+int PointSet::get_dim() const
+{
+    /*!
+     * @brief Returns the dimension of the points of the set
+     *
+     * @return The dimension of the points
+     *
+     */
+
+    return this->d;
+}
+
+double* PointSet::row(int i)
+{
+    /*!
+     * @brief Returns the coordinates of the i-th point
+     *
+     * @param i The index of the point
+     *
+     * @return A pointer to the \p d coordinates of the point
+     *
+     */
+
+    return this->data + (size_t) i * this->d;
+}
+
+const double* PointSet::row(int i) const
+{
+    /*!
+     * @brief Returns the coordinates of the i-th point
+     *
+     * @param i The index of the point
+     *
+     * @return A pointer to the \p d coordinates of the point
+     *
+     */
+
+    return this->data + (size_t) i * this->d;
+}
+
+double* PointSet::get_data()
+{
+    /*!
+     * @brief Returns the row-major coordinates of all the points
+     *
+     * @return A pointer to the \p n * \p d coordinates
+     *
+     */
+
+    return this->data;
+}
+
+void PointSet::build_columns()
+{
+    /*!
+     * @brief Builds the column-major copy of the coordinates. It must be
+     * built again if the coordinates change.
+     *
+     */
+
+    this->columns.resize((size_t) this->n * this->d);
+
+    for (int i = 0; i < this->n; i ++) {
+        const double* x = this->row(i);
+        for (int j = 0; j < this->d; j ++) {
+            this->columns[(size_t) j * this->n + i] = x[j];
+        }
+    }
+}
+
+bool PointSet::has_columns() const
+{
+    /*!
+     * @brief Tells whether the column-major copy has been built
+     *
+     * @return true if build_columns has been called
+     *
+     */
+
+    return this->n == 0 || this->d == 0 || !this->columns.empty();
+}
+
+const double* PointSet::column(int j) const
+{
+    /*!
+     * @brief Returns the j-th coordinate of all the points, once the
+     * column-major copy has been built
+     *
+     * @param j The index of the coordinate
+     *
+     * @return A pointer to the \p n values of the coordinate
+     *
+     */
+
+    assert(this->has_columns() && "Columns have not been built");
+
+    return this->columns.data() + (size_t) j * this->n;
+}
+
+std::vector<Point*> PointSet::make_points()
+{
+    /*!
+     * @brief Builds one Point per row of the set, which views its coordinates
+     * rather than copying them
+     *
+     * @return A vector of pointers to the created points
+     *
+     */
+
+    std::vector<Point*> points(this->n);
+    for (int i = 0; i < this->n; i ++) {
+        points[i] = new Point(this->row(i), this->d);
+    }
+
+    return points;
+}
+
+PointSet* PointSet::read_from_file(std::string file_path, int num_threads)
+{
+    /*!
+     * @brief Builds a set of points from a file, one point per row with
+     * coordinates separated by spaces. The dimension is the number of values
+     * of the first row.
+     *
+     * @param file_path The path to the file to get data from
+     * @param num_threads The number of parsing threads, 0 meaning one per hardware core
+     *
+     * @return The created set of points
+     *
+     */
+
+    int n, d;
+    std::vector<double> coords = Point::read_coords_from_file(file_path, n, d, num_threads);
+
+    return new PointSet(coords, n, d);
+}
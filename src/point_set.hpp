@@ -0,0 +1,49 @@
+#pragma once
+
+#include "point.hpp"
+
+#include <string>
+#include <vector>
+
+#define POINT_SET_ALIGNMENT 64
+
+class PointSet
+{
+    /*!
+     * @class Set of n points of the same dimension d, whose coordinates are
+     * stored contiguously in a single aligned row-major buffer, the j-th
+     * coordinate of the i-th point being at index i*d+j. A column-major copy
+     * can be built on demand for kernels which sweep one coordinate at a time.
+     *
+     */
+
+    private:
+        int n;
+        int d;
+
+        double* data;               // row-major, aligned on POINT_SET_ALIGNMENT bytes
+        std::vector<double> columns; // column-major copy, empty until built
+
+    public:
+        PointSet(int n_, int d_);
+        PointSet(const std::vector<double>& coords, int n_, int d_);
+        ~PointSet();
+
+        PointSet(const PointSet&) = delete;
+        PointSet& operator=(const PointSet&) = delete;
+
+        int size() const;
+        int get_dim() const;
+
+        double* row(int i);
+        const double* row(int i) const;
+        double* get_data();
+
+        void build_columns();
+        bool has_columns() const;
+        const double* column(int j) const;
+
+        std::vector<Point*> make_points();
+
+        static PointSet* read_from_file(std::string file_path, int num_threads = 0);
+};
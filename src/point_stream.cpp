@@ -0,0 +1,132 @@
+#include "point_stream.hpp"
+
+#include <cassert>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+
+namespace
+{
+
+bool is_blank(const std::string& line)
+{
+    for (char c : line) {
+        if (!std::isspace((unsigned char) c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+PointStream::PointStream(std::string file_path_)
+{
+    /*!
+     * @brief Opens a file of points and reads its dimension
+     *
+     * @param file_path_ The path to the file
+     *
+     * @throw std::invalid_argument If the first row holds no value, since
+     * the dimension could not be known
+     *
+     */
+
+    this->file_path = file_path_;
+    this->file.open(file_path_);
+    assert(this->file.is_open() && "No such file");
+
+    // the dimension is the number of values of the first row
+    this->d = 0;
+    if (std::getline(this->file, this->line)) {
+        const char* c = this->line.c_str();
+        while (*c != '\0') {
+            while (*c == ' ' || *c == '\t' || *c == '\r') {
+                c ++;
+            }
+            if (*c != '\0') {
+                this->d += 1;
+                while (*c != '\0' && !std::isspace((unsigned char) *c)) {
+                    c ++;
+                }
+            }
+        }
+    }
+
+    if (this->d == 0) {
+        throw std::invalid_argument("No dimension in the first row of " + this->file_path);
+    }
+
+    this->rewind();
+}
+
+int PointStream::get_dim() const
+{
+    /*!
+     * @brief Getter of the dimension
+     *
+     * @return The dimension of the points of the file
+     *
+     */
+
+    return this->d;
+}
+
+int PointStream::read_chunk(double* coords, int max_points)
+{
+    /*!
+     * @brief Parses the next rows of the file, blank rows being skipped
+     *
+     * @param coords The buffer of \p max_points * d values to fill, row-major
+     * @param max_points The maximal number of points to read
+     *
+     * @return The number of points read, 0 once the end of the file is reached
+     *
+     */
+
+    int count = 0;
+
+    while (count < max_points && std::getline(this->file, this->line)) {
+        if (is_blank(this->line)) {
+            continue;
+        }
+
+        const char* p = this->line.data();
+        const char* row_end = p + this->line.size();
+        double* x = coords + (size_t) count * this->d;
+
+        for (int j = 0; j < this->d; j ++) {
+            while (p < row_end && (*p == ' ' || *p == '\t')) {
+                p ++;
+            }
+
+            std::from_chars_result result = std::from_chars(p, row_end, x[j]);
+            if (result.ec != std::errc()) {
+                throw std::invalid_argument("Malformed row in " + this->file_path);
+            }
+            p = result.ptr;
+        }
+
+        while (p < row_end && std::isspace((unsigned char) *p)) {
+            p ++;
+        }
+        if (p < row_end) {
+            throw std::invalid_argument("Malformed row in " + this->file_path);
+        }
+
+        count += 1;
+    }
+
+    return count;
+}
+
+void PointStream::rewind()
+{
+    /*!
+     * @brief Goes back to the first row of the file, for another pass
+     *
+     */
+
+    this->file.clear();
+    this->file.seekg(0);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+class PointStream
+{
+    /*!
+     * @class Reads a file of points, one per row with coordinates separated by
+     * spaces, a chunk of rows at a time, so that files larger than memory can
+     * be processed. The dimension is the number of values of the first row.
+     *
+     */
+
+    private:
+        std::string file_path;
+        std::ifstream file;
+        std::string line;
+        int d;
+
+    public:
+        PointStream(std::string file_path_);
+
+        PointStream(const PointStream&) = delete;
+        PointStream& operator=(const PointStream&) = delete;
+
+        int get_dim() const;
+
+        int read_chunk(double* coords, int max_points);
+        void rewind();
+};
@@ -0,0 +1,109 @@
+#include "radix_sort.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#define RADIX_BITS 11
+#define RADIX_SIZE (1 << RADIX_BITS)
+#define RADIX_MASK (RADIX_SIZE - 1)
+#define RADIX_PASSES ((64 + RADIX_BITS - 1) / RADIX_BITS)
+
+// below this size, the counting arrays cost more than a comparison sort
+#define RADIX_MIN_SIZE 1024
+
+uint64_t weight_sort_key(edge_weight_t weight)
+{
+    /*!
+     * @brief Maps a weight to an unsigned integer key with the same order, 
+     * by flipping the bits of its IEEE-754 representation
+     * 
+     * @param weight The weight of an edge
+     * 
+     * @return A key such that weight_sort_key(a) < weight_sort_key(b) iff a < b
+     * 
+     */
+
+    uint64_t bits;
+    std::memcpy(&bits, &weight, sizeof(bits));
+
+    // negative numbers are ordered backwards, positive ones only need their sign flipped
+    return (bits & 0x8000000000000000ULL) ? ~bits : (bits | 0x8000000000000000ULL);
+}
+
+void radix_sort_edges(std::vector<WeightedEdge>& edges)
+{
+    /*!
+     * @brief Sorts edges by increasing weight, see \ref radix_sort_edges(WeightedEdge* edges, int m)
+     * 
+     * @param edges The edges to sort in place
+     * 
+     */
+
+    radix_sort_edges(edges.data(), edges.size());
+}
+
+void radix_sort_edges(WeightedEdge* edges, int m)
+{
+    /*!
+     * @brief Sorts edges by increasing weight, using a LSD radix sort on the 
+     * bits of the weights. The sort is stable, hence edges of equal weight 
+     * keep their relative order.
+     * 
+     * @param edges Pointer to the first edge to sort in place
+     * @param m Number of edges to sort
+     * 
+     */
+
+    if (m < RADIX_MIN_SIZE) {
+        std::stable_sort(edges, edges + m, 
+            [](const WeightedEdge& e1, const WeightedEdge& e2) { return e1.weight < e2.weight; });
+        return;
+    }
+
+    std::vector<uint64_t> keys(m);
+    for (int i = 0; i < m; i ++) {
+        keys[i] = weight_sort_key(edges[i].weight);
+    }
+
+    std::vector<WeightedEdge> edges_buffer(m);
+    std::vector<uint64_t> keys_buffer(m);
+    std::vector<int> counts(RADIX_SIZE);
+
+    WeightedEdge* src = edges;
+    WeightedEdge* dst = edges_buffer.data();
+
+    for (int pass = 0; pass < RADIX_PASSES; pass ++) {
+        int shift = pass*RADIX_BITS;
+
+        std::fill(counts.begin(), counts.end(), 0);
+        for (int i = 0; i < m; i ++) {
+            counts[(keys[i] >> shift) & RADIX_MASK] += 1;
+        }
+
+        // skipping the passes where all the keys share the same digit
+        if (counts[(keys[0] >> shift) & RADIX_MASK] == m) {
+            continue;
+        }
+
+        int total = 0;
+        for (int digit = 0; digit < RADIX_SIZE; digit ++) {
+            int count = counts[digit];
+            counts[digit] = total;
+            total += count;
+        }
+
+        for (int i = 0; i < m; i ++) {
+            int pos = counts[(keys[i] >> shift) & RADIX_MASK]++;
+            keys_buffer[pos] = keys[i];
+            dst[pos] = src[i];
+        }
+
+        keys.swap(keys_buffer);
+        std::swap(src, dst);
+    }
+
+    // after an odd number of effective passes, the result lies in the buffer
+    if (src != edges) {
+        std::copy(src, src + m, edges);
+    }
+}
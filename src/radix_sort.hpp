@@ -0,0 +1,10 @@
+#pragma once
+
+#include "csr_graph.hpp"
+
+#include <vector>
+#include <cstdint>
+
+uint64_t weight_sort_key(edge_weight_t weight);
+void radix_sort_edges(std::vector<WeightedEdge>& edges);
+void radix_sort_edges(WeightedEdge* edges, int m);
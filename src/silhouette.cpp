@@ -0,0 +1,404 @@
+#include "silhouette.hpp"
+#include "pairwise.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+struct ClusterSortedPoints
+{
+    std::vector<double> coords;     // row-major, cluster after cluster
+    std::vector<int> labels;
+    std::vector<int> cluster_begin; // the points of cluster c are in [cluster_begin[c], cluster_begin[c+1])
+};
+
+void sort_by_cluster(const double* coords, const int* labels, int n, int d, int k, ClusterSortedPoints& sorted)
+{
+    /*!
+     * @brief Copies the points cluster by cluster, with a counting sort
+     *
+     */
+
+    sorted.cluster_begin.assign(k+1, 0);
+    for (int i = 0; i < n; i ++) {
+        sorted.cluster_begin[labels[i]+1] += 1;
+    }
+    for (int c = 0; c < k; c ++) {
+        sorted.cluster_begin[c+1] += sorted.cluster_begin[c];
+    }
+
+    sorted.coords.resize((size_t) n * d);
+    sorted.labels.resize(n);
+
+    std::vector<int> next(sorted.cluster_begin.begin(), sorted.cluster_begin.end() - 1);
+    for (int i = 0; i < n; i ++) {
+        int s = next[labels[i]] ++;
+        sorted.labels[s] = labels[i];
+        std::copy(coords + (size_t) i * d, coords + (size_t) (i+1) * d, sorted.coords.begin() + (size_t) s * d);
+    }
+}
+
+void add_to_clusters(const ClusterSortedPoints& sorted, double* dist_to_clusters, const double* dist, int col_begin, int col_end)
+{
+    /*!
+     * @brief Adds the distances from a point to the sorted points of
+     * [col_begin, col_end), given squared, to its sums per cluster, one
+     * cluster at a time
+     *
+     */
+
+    int j = col_begin;
+    while (j < col_end) {
+        int c = sorted.labels[j];
+        int segment_end = std::min(col_end, sorted.cluster_begin[c+1]);
+
+        double sum = 0.0;
+        for (; j < segment_end; j ++) {
+            sum += std::sqrt(dist[j - col_begin]);
+        }
+        dist_to_clusters[c] += sum;
+    }
+}
+
+void add_pair_tile(const ClusterSortedPoints& sorted, double* dist_to_clusters, int k, int row_begin, int col_begin, bool diagonal,
+    int r0, int r1, int c0, int c1, const double* tile)
+{
+    /*!
+     * @brief Adds the distances of a tile between the sorted points from
+     * row_begin and those from col_begin, given squared, to the sums per
+     * cluster of both points of each pair. On a diagonal tile, both sets
+     * being the same, only the pairs above the diagonal are visited.
+     *
+     */
+
+    for (int i = r0; i < r1; i ++) {
+        const double* dist = tile + (size_t) (i - r0) * PAIRWISE_TILE_SIZE;
+        int first = diagonal ? std::max(c0, i+1) : c0;
+        if (first >= c1) {
+            continue;
+        }
+
+        // each distance is added to both points, one cluster at a time
+        double* dist_i = dist_to_clusters + (size_t) (row_begin + i) * k;
+        int label_i = sorted.labels[row_begin + i];
+
+        int j = first;
+        while (j < c1) {
+            int c = sorted.labels[col_begin + j];
+            int segment_end = std::min(c1, sorted.cluster_begin[c+1] - col_begin);
+
+            double sum = 0.0;
+            for (; j < segment_end; j ++) {
+                double value = std::sqrt(dist[j - c0]);
+                sum += value;
+                dist_to_clusters[(size_t) (col_begin + j) * k + label_i] += value;
+            }
+            dist_i[c] += sum;
+        }
+    }
+}
+
+double point_silhouette(const ClusterSortedPoints& sorted, const double* dist_to_clusters, int label, int k)
+{
+    /*!
+     * @brief Silhouette of a point given its sums of distances per cluster,
+     * a and b being respectively the average distance to the other points of
+     * the same cluster and the min of average distances to foreign clusters
+     *
+     */
+
+    int size = sorted.cluster_begin[label+1] - sorted.cluster_begin[label];
+
+    double b = DBL_MAX;
+    for (int c = 0; c < k; c ++) {
+        int other_size = sorted.cluster_begin[c+1] - sorted.cluster_begin[c];
+        if (c != label && other_size > 0) {
+            b = std::min(b, dist_to_clusters[c] / other_size);
+        }
+    }
+
+    if (size <= 1 || b == DBL_MAX) {
+        return 0.0;
+    }
+
+    double a = dist_to_clusters[label] / (size - 1);
+    if (std::max(a, b) > 0) {
+        return (b - a) / std::max(a, b);
+    }
+    return 0.0;
+}
+
+}
+
+std::vector<std::vector<std::pair<int, int>>> silhouette_block_rounds(int num_blocks)
+{
+    /*!
+     * @brief Schedules the pairs of blocks (a, b) with a <= b in rounds, so
+     * that the pairs of a round never share a block. The pairs of distinct
+     * blocks follow the circle method of round-robin tournaments, a dummy
+     * block completing an odd count, and a last round holds the pairs (a, a).
+     *
+     * @param num_blocks The number of blocks
+     *
+     * @return The pairs of each round, each pair appearing in exactly one round
+     *
+     */
+
+    std::vector<std::vector<std::pair<int, int>>> rounds;
+
+    // block m-1 stays in place while the others rotate
+    int m = num_blocks + num_blocks % 2;
+    for (int r = 0; r < m - 1; r ++) {
+        std::vector<std::pair<int, int>> round;
+        for (int i = 0; i < m / 2; i ++) {
+            int a = (i == 0) ? m - 1 : (r + i) % (m - 1);
+            int b = (r - i + m - 1) % (m - 1);
+            if (a < num_blocks && b < num_blocks) {
+                round.push_back({std::min(a, b), std::max(a, b)});
+            }
+        }
+        rounds.push_back(round);
+    }
+
+    std::vector<std::pair<int, int>> diagonal;
+    for (int a = 0; a < num_blocks; a ++) {
+        diagonal.push_back({a, a});
+    }
+    rounds.push_back(diagonal);
+
+    return rounds;
+}
+
+double silhouette_score(const double* coords, const int* labels, int n, int d, int k, ThreadPool& pool)
+{
+    /*!
+     * @brief Computes the mean silhouette of a clustering, where the silhouette
+     * of a point is (b-a)/max(a,b), a being its mean distance to the other
+     * points of its cluster and b the smallest mean distance to the points of
+     * another cluster. Points alone in their cluster have a silhouette of 0.
+     *
+     * The points are sorted by cluster, so that each row of a distance tile
+     * is summed cluster by cluster over contiguous columns. The points are
+     * split into blocks, and the pairs of blocks (a, b) with a <= b, each
+     * computed once, are scheduled in rounds whose pairs touch distinct
+     * blocks. The threads of a round can thus add to the shared n*k sums
+     * without locks, and memory stays in O(n*k) whatever the number of
+     * threads, besides one distance tile per thread.
+     *
+     * @param coords The row-major coordinates of the \p n points
+     * @param labels The cluster of each point, in [0, k)
+     * @param n The number of points
+     * @param d The dimension of the points
+     * @param k The number of clusters
+     * @param pool The threads
+     *
+     * @return The silhouette of the clustering
+     *
+     */
+
+    if (n == 0) {
+        return 0.0;
+    }
+
+    ClusterSortedPoints sorted;
+    sort_by_cluster(coords, labels, n, d, k, sorted);
+
+    // two blocks per thread, so that each round has a pair for every thread
+    int num_threads = pool.get_num_threads();
+    int num_blocks = std::max(1, std::min(2 * num_threads, n / SILHOUETTE_MIN_ROWS));
+
+    std::vector<std::vector<std::pair<int, int>>> rounds = silhouette_block_rounds(num_blocks);
+
+    // sums of the distances from each point to the points of each cluster,
+    // shared by the threads: the only buffer in O(n*k), which must not be
+    // duplicated per thread
+    std::vector<double> dist_to_clusters((size_t) n * k, 0.0);
+
+    for (const std::vector<std::pair<int, int>>& round : rounds) {
+        pool.run(round.size(), [&](int, int pair_begin, int pair_end) {
+            for (int p = pair_begin; p < pair_end; p ++) {
+                int a = round[p].first;
+                int b = round[p].second;
+                int row_begin = (long long) n * a / num_blocks;
+                int row_end = (long long) n * (a+1) / num_blocks;
+                int col_begin = (long long) n * b / num_blocks;
+                int col_end = (long long) n * (b+1) / num_blocks;
+                const double* rows = sorted.coords.data() + (size_t) row_begin * d;
+                const double* cols = sorted.coords.data() + (size_t) col_begin * d;
+
+                auto consumer = [&](int r0, int r1, int c0, int c1, const double* tile) {
+                    add_pair_tile(sorted, dist_to_clusters.data(), k, row_begin, col_begin, a == b, r0, r1, c0, c1, tile);
+                };
+
+                if (a == b) {
+                    pairwise_squared_distances(rows, row_end - row_begin, d, consumer);
+                } else {
+                    pairwise_squared_distances(rows, row_end - row_begin, cols, col_end - col_begin, d, consumer);
+                }
+            }
+        });
+    }
+
+    double silhouette = 0.0;
+    for (int i = 0; i < n; i ++) {
+        silhouette += point_silhouette(sorted, dist_to_clusters.data() + (size_t) i * k, sorted.labels[i], k);
+    }
+
+    return silhouette / n;
+}
+
+double silhouette_score(const double* coords, const int* labels, int n, int d, int k, int num_threads)
+{
+    /*!
+     * @brief Computes the mean silhouette of a clustering on its own threads
+     *
+     * @param num_threads The number of threads, 0 meaning one per hardware core
+     *
+     */
+
+    ThreadPool pool(resolve_num_threads(num_threads));
+    return silhouette_score(coords, labels, n, d, k, pool);
+}
+
+SilhouetteEstimate sampled_silhouette_score(const double* coords, const int* labels, int n, int d, int k, int sample_size, ThreadPool& pool)
+{
+    /*!
+     * @brief Estimates the silhouette of a clustering from a sample of its
+     * points, in O(sample_size * n) rather than O(n^2). The sample is
+     * stratified: each cluster gets a share proportional to its size, drawn
+     * without replacement with rand(), and at least two points when it has
+     * that many, so that every stratum contributes to the variance. The
+     * actual sample may therefore exceed \p sample_size by a few points per
+     * cluster. The silhouette of each sampled point is exact, being computed
+     * against all the points.
+     *
+     * @param coords The row-major coordinates of the \p n points
+     * @param labels The cluster of each point, in [0, k)
+     * @param n The number of points
+     * @param d The dimension of the points
+     * @param k The number of clusters
+     * @param sample_size The approximate number of points to sample, the
+     * exact silhouette being computed if it is at least \p n
+     * @param pool The threads
+     *
+     * @return The estimate, with the half width of its 95% confidence interval
+     * and the actual number of sampled points
+     *
+     */
+
+    if (sample_size >= n) {
+        SilhouetteEstimate exact = {silhouette_score(coords, labels, n, d, k, pool), 0.0, n};
+        return exact;
+    }
+
+    ClusterSortedPoints sorted;
+    sort_by_cluster(coords, labels, n, d, k, sorted);
+
+    // the sample of each cluster, by partial Fisher-Yates shuffles
+    std::vector<int> sample;
+    std::vector<int> sample_begin(k+1, 0);
+    std::vector<int> positions;
+
+    for (int c = 0; c < k; c ++) {
+        int cluster_size = sorted.cluster_begin[c+1] - sorted.cluster_begin[c];
+        int cluster_sample = 0;
+        if (cluster_size > 0) {
+            cluster_sample = (int) std::llround((double) sample_size * cluster_size / n);
+            cluster_sample = std::max(std::min(2, cluster_size), std::min(cluster_size, cluster_sample));
+        }
+
+        positions.resize(cluster_size);
+        for (int l = 0; l < cluster_size; l ++) {
+            positions[l] = sorted.cluster_begin[c] + l;
+        }
+        for (int l = 0; l < cluster_sample; l ++) {
+            std::swap(positions[l], positions[l + rand() % (cluster_size - l)]);
+            sample.push_back(positions[l]);
+        }
+
+        sample_begin[c+1] = sample.size();
+    }
+
+    int m = sample.size();
+
+    std::vector<double> sample_coords((size_t) m * d);
+    for (int s = 0; s < m; s ++) {
+        const double* x = sorted.coords.data() + (size_t) sample[s] * d;
+        std::copy(x, x + d, sample_coords.begin() + (size_t) s * d);
+    }
+
+    // sums of distances from each sampled point to each cluster, the 
+    // threads sharing the sampled points
+    std::vector<double> dist_to_clusters((size_t) m * k, 0.0);
+
+    int num_blocks = std::max(1, std::min(pool.get_num_threads(), (m + PAIRWISE_TILE_SIZE - 1) / PAIRWISE_TILE_SIZE));
+
+    pool.run(num_blocks, [&](int, int block_begin, int block_end) {
+        for (int block = block_begin; block < block_end; block ++) {
+            int row_begin = (long long) m * block / num_blocks;
+            int row_end = (long long) m * (block+1) / num_blocks;
+            const double* rows = sample_coords.data() + (size_t) row_begin * d;
+
+            pairwise_squared_distances(rows, row_end - row_begin, sorted.coords.data(), n, d, [&](int r0, int r1, int c0, int c1, const double* tile) {
+                for (int i = r0; i < r1; i ++) {
+                    double* dist_i = dist_to_clusters.data() + (size_t) (row_begin + i) * k;
+                    add_to_clusters(sorted, dist_i, tile + (size_t) (i - r0) * PAIRWISE_TILE_SIZE, c0, c1);
+                }
+            });
+        }
+    });
+
+    // stratified mean, and its variance with the finite population correction
+    double value = 0.0;
+    double variance = 0.0;
+
+    for (int c = 0; c < k; c ++) {
+        int cluster_size = sorted.cluster_begin[c+1] - sorted.cluster_begin[c];
+        int cluster_sample = sample_begin[c+1] - sample_begin[c];
+        if (cluster_sample == 0) {
+            continue;
+        }
+
+        double sum = 0.0;
+        double sum_squares = 0.0;
+        for (int s = sample_begin[c]; s < sample_begin[c+1]; s ++) {
+            double silhouette = point_silhouette(sorted, dist_to_clusters.data() + (size_t) s * k, c, k);
+            sum += silhouette;
+            sum_squares += silhouette * silhouette;
+        }
+
+        double weight = (double) cluster_size / n;
+        double mean = sum / cluster_sample;
+        value += weight * mean;
+
+        if (cluster_sample > 1) {
+            double sample_variance = std::max(0.0, (sum_squares - cluster_sample * mean * mean) / (cluster_sample - 1));
+            double correction = 1.0 - (double) cluster_sample / cluster_size;
+            variance += weight * weight * correction * sample_variance / cluster_sample;
+        }
+    }
+
+    SilhouetteEstimate estimate = {value, SILHOUETTE_CONFIDENCE_Z * std::sqrt(variance), m};
+    return estimate;
+}
+
+SilhouetteEstimate sampled_silhouette_score(const double* coords, const int* labels, int n, int d, int k, int sample_size, int num_threads)
+{
+    /*!
+     * @brief Estimates the silhouette of a clustering on its own threads
+     *
+     * @param num_threads The number of threads, 0 meaning one per hardware core
+     *
+     */
+
+    ThreadPool pool(resolve_num_threads(num_threads));
+    return sampled_silhouette_score(coords, labels, n, d, k, sample_size, pool);
+}
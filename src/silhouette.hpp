@@ -0,0 +1,25 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+// minimal number of points per block, the threads sharing the pairs of blocks
+#define SILHOUETTE_MIN_ROWS 512
+
+// quantile of the normal distribution for 95% confidence intervals
+#define SILHOUETTE_CONFIDENCE_Z 1.96
+
+class ThreadPool;
+
+struct SilhouetteEstimate
+{
+    double value;       // estimated silhouette
+    double half_width;  // the silhouette is in value +/- half_width with 95% confidence
+    int sample_size;    // number of points whose silhouette was computed
+};
+
+std::vector<std::vector<std::pair<int, int>>> silhouette_block_rounds(int num_blocks);
+double silhouette_score(const double* coords, const int* labels, int n, int d, int k, ThreadPool& pool);
+double silhouette_score(const double* coords, const int* labels, int n, int d, int k, int num_threads = 0);
+SilhouetteEstimate sampled_silhouette_score(const double* coords, const int* labels, int n, int d, int k, int sample_size, ThreadPool& pool);
+SilhouetteEstimate sampled_silhouette_score(const double* coords, const int* labels, int n, int d, int k, int sample_size, int num_threads = 0);
@@ -0,0 +1,122 @@
+#include "thread_pool.hpp"
+
+ThreadPool::ThreadPool(int num_threads_)
+{
+    /*!
+     * @brief Starts the worker threads
+     * 
+     * @param num_threads_ The number of threads, the calling thread being one of them
+     * 
+     */
+
+    this->num_threads = (num_threads_ > 0) ? num_threads_ : 1;
+    this->n = 0;
+    this->generation = 0;
+    this->pending = 0;
+    this->stopping = false;
+
+    for (int t = 1; t < this->num_threads; t ++) {
+        this->workers.push_back(std::thread(&ThreadPool::worker_loop, this, t));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    /*!
+     * @brief Stops and joins the worker threads
+     * 
+     */
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->work_ready.notify_all();
+
+    for (std::thread& worker : this->workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::get_num_threads()
+{
+    return this->num_threads;
+}
+
+void ThreadPool::run_block(int thread)
+{
+    /*!
+     * @brief Runs the block of the current loop assigned to \p thread
+     * 
+     */
+
+    int begin = (long long) this->n * thread / this->num_threads;
+    int end = (long long) this->n * (thread+1) / this->num_threads;
+
+    this->task(thread, begin, end);
+}
+
+void ThreadPool::worker_loop(int thread)
+{
+    /*!
+     * @brief Waits for loops to run, until the pool is destroyed
+     * 
+     * @param thread The index of the worker
+     * 
+     */
+
+    int seen_generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->work_ready.wait(lock, [&] { return this->stopping || this->generation != seen_generation; });
+
+            if (this->stopping) {
+                return;
+            }
+            seen_generation = this->generation;
+        }
+
+        this->run_block(thread);
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->pending -= 1;
+            if (this->pending == 0) {
+                this->work_done.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::run(int n_, std::function<void(int, int, int)> f)
+{
+    /*!
+     * @brief Splits [0, n_) into one contiguous block per thread, and calls 
+     * f(thread, begin, end) on each block. Returns once all the blocks are done.
+     * 
+     * @param n_ The number of iterations
+     * @param f The work to do on a block
+     * 
+     */
+
+    if (this->num_threads == 1) {
+        f(0, 0, n_);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->task = f;
+        this->n = n_;
+        this->pending = this->num_threads - 1;
+        this->generation += 1;
+    }
+    this->work_ready.notify_all();
+
+    this->run_block(0);
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->work_done.wait(lock, [&] { return this->pending == 0; });
+}
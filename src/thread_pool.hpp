@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+inline int resolve_num_threads(int num_threads)
+{
+    /*!
+     * @brief Returns the number of threads to use
+     *
+     * @param num_threads The requested number of threads, 0 meaning one thread
+     * per hardware core
+     *
+     * @return A positive number of threads
+     *
+     */
+
+    if (num_threads > 0) {
+        return num_threads;
+    }
+
+    int hardware_threads = std::thread::hardware_concurrency();
+    return std::max(hardware_threads, 1);
+}
+
+class ThreadPool
+{
+
+    /*!
+     * @class Fixed set of worker threads, which run the blocks of many small 
+     * parallel loops without creating threads for each of them
+     *
+     */
+
+    private:
+        int num_threads;
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable work_ready;
+        std::condition_variable work_done;
+
+        std::function<void(int, int, int)> task;
+        int n;
+        int generation;  // number of loops started, so that workers wake up once per loop
+        int pending;     // number of workers still running the current loop
+        bool stopping;
+
+        void run_block(int thread);
+        void worker_loop(int thread);
+
+    public:
+        ThreadPool(int num_threads_);
+        ~ThreadPool();
+
+        int get_num_threads();
+
+        void run(int n_, std::function<void(int, int, int)> f);
+};
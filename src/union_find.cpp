@@ -98,7 +98,7 @@ Node* UnionFind::Find(Node* node)
      * 
      */
 
-    assert(("This node is not part of the data structure", this->get_parent(node) != NULL));
+    assert(this->get_parent(node) != NULL && "This node is not part of the data structure");
 
     Node* parent = this->get_parent(node);
 
@@ -143,4 +143,131 @@ void UnionFind::Union(Node* n1, Node* n2)
             this->rank[rep2] += 1;
         }
     }
-}
\ No newline at end of file
+}
+
+// Flat (id-indexed) version
+
+FlatUnionFind::FlatUnionFind(int n) 
+{
+    /*!
+     * @brief Builds the Union-Find data structure over the identifiers 
+     * 0, ..., n-1, each of them being its own class
+     * 
+     * @param n Number of identifiers
+     * 
+     */
+
+    this->num_classes = n;
+    this->parent.resize(n);
+    this->size.assign(n, 1);
+
+    for (int i = 0; i < n; i ++) {
+        this->parent[i] = i;
+    }
+}
+
+FlatUnionFind::~FlatUnionFind() {} 
+
+int FlatUnionFind::get_parent(int id) 
+{
+    /*!
+     * @brief Returns the parent of \p id in the data structure, if it exists
+     * 
+     * @param id Identifier of which we want the parent
+     * 
+     * @return -1 if the identifier is out of range, otherwise its parent
+     * 
+     */
+
+    if (id < 0 || id >= (int)this->parent.size()) {
+        return -1;
+    }
+    return this->parent[id];
+}
+
+int FlatUnionFind::get_size(int id)
+{
+    /*!
+     * @brief Returns the size of the class whose representative is \p id
+     * 
+     * @param id Identifier of a representative
+     * 
+     * @return 0 if the identifier is out of range, otherwise the number of 
+     * elements it represents (meaningless if \p id is not a representative)
+     * 
+     */
+
+    if (id < 0 || id >= (int)this->size.size()) {
+        return 0;
+    }
+    return this->size[id];
+}
+
+int FlatUnionFind::get_num_classes()
+{
+    /*!
+     * @brief Returns the number of classes of this data structure
+     *
+     * @return num_classes from the data structure
+     * 
+     */
+
+    return this->num_classes;
+}
+
+int FlatUnionFind::Find(int id)
+{
+    /*!
+     * @brief Finds the representative of \p id, using iterative path halving:
+     * every visited identifier is linked to its grandparent
+     * 
+     * @param id Identifier of which we want the representative
+     * 
+     * @return The representative of \p id
+     * 
+     */
+
+    assert(id >= 0 && id < (int)this->parent.size() && "This identifier is not part of the data structure");
+
+    int* parent = this->parent.data();
+
+    while (parent[id] != id) {
+        parent[id] = parent[parent[id]];
+        id = parent[id];
+    }
+
+    return id;
+}
+
+bool FlatUnionFind::Union(int id1, int id2)
+{
+    /*!
+     * @brief Computes the union of the classes of \p id1 and \p id2, the 
+     * biggest class becoming the parent of the other one
+     * 
+     * @param id1 First identifier 
+     * @param id2 Second identifier
+     * 
+     * @return true if two different classes have been merged, false otherwise
+     * 
+     */
+
+    int rep1 = this->Find(id1);
+    int rep2 = this->Find(id2);
+
+    if (rep1 == rep2) {
+        return false;
+    }
+
+    this->num_classes -= 1; // proceeding with Union
+
+    if (this->size[rep1] > this->size[rep2]) {
+        this->parent[rep2] = rep1;
+        this->size[rep1] += this->size[rep2];
+    } else { // arbitrary choice when sizes are equal
+        this->parent[rep1] = rep2;
+        this->size[rep2] += this->size[rep1];
+    }
+
+    return true;
+}
@@ -30,4 +30,30 @@ public:
 
     Node* Find(Node* node);
     void Union(Node* n1, Node* n2);
-};
\ No newline at end of file
+};
+
+class FlatUnionFind 
+{
+
+    /*!
+     * @class Union-Find data structure over node identifiers in [0, n),
+     * stored in flat arrays, with path halving and union by size
+     *
+     */
+
+protected:
+    std::vector<int> parent;
+    std::vector<int> size;
+    int num_classes;
+    
+public:
+    FlatUnionFind(int n);
+    ~FlatUnionFind();
+
+    int get_parent(int id);
+    int get_size(int id);
+    int get_num_classes();
+
+    int Find(int id);
+    bool Union(int id1, int id2);
+};
@@ -2,6 +2,8 @@
 
 #include "../src/graph.hpp"
 #include <unordered_set>
+#include <cstring>
+#include <stdexcept>
 
 TEST_CASE("Simple graph construction", "[graph:init]") 
 {
@@ -44,7 +46,8 @@ TEST_CASE("Simple graph construction", "[graph:init]")
     SECTION("Tests of edges- Will not expand the iterator of the set but works") 
     {
 
-        std::unordered_set<Edge*> set1 = my_graph.connected_edges(&my_nodes[5]);
+        std::vector<Edge*> connected = my_graph.connected_edges(&my_nodes[5]);
+        std::unordered_set<Edge*> set1(connected.begin(), connected.end());
         Edge not_in_graph = Edge(&my_nodes[1], &my_nodes[5]);
         Edge duplicate = Edge(&my_nodes[0], &my_nodes[9]);
 
@@ -166,4 +169,219 @@ TEST_CASE("Tests for the total weight computation", "[graph:weight]")
     double weight = my_graph.total_weight();
 
     REQUIRE(std::abs(weight - 90) < 0.001);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Tests of the CSR view of the graph", "[graph:csr]")
+{
+    std::vector<Node> my_nodes;
+    std::vector<Edge> my_edges;
+
+    // Creating nodes "i"
+    for(int i = 0; i < 4; i++){
+        my_nodes.push_back(Node(i));
+    }
+
+    // Path 0 - 1 - 2 - 3 with weight i+1, plus edge 0 - 3 with weight 10
+    for(int i = 0; i < 3; i++){
+        my_edges.push_back(Edge(&my_nodes[i], &my_nodes[i+1], i+1));
+    }
+    my_edges.push_back(Edge(&my_nodes[0], &my_nodes[3], 10));
+
+    Graph my_graph;
+
+    for(int i = 0; i < 4; i++){
+        my_graph.add_edge(&my_edges[i]);
+    }
+
+    REQUIRE(my_graph.is_frozen() == false);
+
+    const CSRGraph& csr = my_graph.get_csr();
+
+    REQUIRE(my_graph.is_frozen() == true);
+
+    SECTION("Sizes and degrees")
+    {
+        REQUIRE(csr.n == 4);
+        REQUIRE(csr.m == 4);
+        REQUIRE(csr.offsets.size() == 5);
+        REQUIRE(csr.targets.size() == 8);
+
+        for (int i = 0; i < 4; i ++) {
+            REQUIRE(csr.degree(i) == 2);
+        }
+    }
+
+    SECTION("Adjacency matches the graph")
+    {
+        for (node_id_t u = 0; u < csr.n; u ++) {
+            Node* node = my_graph.get_node(u);
+            std::vector<Edge*> edges = my_graph.connected_edges(node);
+            std::unordered_set<Edge*> connected(edges.begin(), edges.end());
+
+            for (int slot = csr.offsets[u]; slot < csr.offsets[u+1]; slot ++) {
+                Edge* e = my_graph.get_edge(csr.edge_ids[slot]);
+
+                REQUIRE(connected.find(e) != connected.end());
+                REQUIRE(e->other_node(node) == my_graph.get_node(csr.targets[slot]));
+                REQUIRE(e->weight == csr.weights[slot]);
+            }
+        }
+    }
+
+    SECTION("Flat edge list")
+    {
+        for (edge_id_t i = 0; i < csr.m; i ++) {
+            Edge* e = my_graph.get_edge(i);
+
+            REQUIRE(csr.edges[i].id == i);
+            REQUIRE(my_graph.get_node(csr.edges[i].u) == e->p1);
+            REQUIRE(my_graph.get_node(csr.edges[i].v) == e->p2);
+            REQUIRE(csr.edges[i].weight == e->weight);
+        }
+    }
+
+    SECTION("Nodes and edges shared with another graph")
+    {
+        // a second graph (eg. a MST) taking the nodes in another order
+        Graph other;
+        for(int i = 3; i >= 0; i--){
+            other.add_edge(&my_edges[i]);
+        }
+
+        const CSRGraph& other_csr = other.get_csr();
+
+        REQUIRE(other_csr.n == 4);
+        REQUIRE(other_csr.m == 4);
+        REQUIRE(other.get_node(0) == &my_nodes[0]);
+        REQUIRE(other.get_node(1) == &my_nodes[3]);
+
+        for (edge_id_t i = 0; i < other_csr.m; i ++) {
+            Edge* e = other.get_edge(i);
+
+            REQUIRE(other.get_node(other_csr.edges[i].u) == e->p1);
+            REQUIRE(other.get_node(other_csr.edges[i].v) == e->p2);
+        }
+
+        // the first graph still finds its nodes and edges
+        for(int i = 0; i < 4; i++){
+            REQUIRE(my_graph.has_node(&my_nodes[i]) == true);
+            REQUIRE(my_graph.get_node(i) == &my_nodes[i]);
+
+            my_graph.add_edge(&my_edges[i]);
+        }
+
+        REQUIRE(my_graph.get_number_of_edges() == 4);
+        REQUIRE(my_graph.get_csr().edges[3].u == 0);
+        REQUIRE(my_graph.get_csr().edges[3].v == 3);
+    }
+
+    SECTION("Adding an edge invalidates the view")
+    {
+        Edge extra = Edge(&my_nodes[1], &my_nodes[3], 5);
+        my_graph.add_edge(&extra);
+
+        REQUIRE(my_graph.is_frozen() == false);
+        REQUIRE(my_graph.get_csr().m == 5);
+        REQUIRE(my_graph.get_csr().degree(3) == 3);
+    }
+}
+
+TEST_CASE("Binary graph files", "[graph:binary]")
+{
+    std::vector<Node> my_nodes;
+    std::vector<Edge> my_edges;
+
+    // Creating nodes with labels "10*i"
+    for(int i = 0; i < 5; i++){
+        my_nodes.push_back(Node(10*i));
+    }
+
+    // Star around node 0, plus edge 3 - 4
+    for(int i = 1; i < 5; i++){
+        my_edges.push_back(Edge(&my_nodes[0], &my_nodes[i], 0.5*i));
+    }
+    my_edges.push_back(Edge(&my_nodes[3], &my_nodes[4], 0.125));
+
+    Graph my_graph;
+
+    for(int i = 0; i < 5; i++){
+        my_graph.add_edge(&my_edges[i]);
+    }
+
+    std::string file_path = "test_graph.bin";
+    write_binary_graph(&my_graph, file_path);
+
+    REQUIRE(is_binary_graph(file_path) == true);
+
+    std::ifstream is(file_path, std::ios::binary);
+    std::string bytes((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    is.close();
+
+    Graph loaded = Graph(file_path);
+    std::remove(file_path.c_str());
+
+    // the CSR view comes straight from the file
+    REQUIRE(loaded.is_frozen() == true);
+    REQUIRE(loaded.get_csr().m == 5);
+    REQUIRE(loaded.get_csr().degree(0) == 4);
+    REQUIRE(loaded.get_csr().degree(3) == 2);
+
+    REQUIRE(loaded.get_number_of_nodes() == 5);
+    REQUIRE(loaded.get_number_of_edges() == 5);
+    REQUIRE(loaded.total_weight() == my_graph.total_weight());
+
+    // same labels, and same weights between the same labels
+    std::unordered_set<int> labels;
+    for (Node* n : loaded.get_nodes()) {
+        labels.insert(n->label);
+    }
+    REQUIRE(labels.size() == 5);
+    REQUIRE(labels.find(40) != labels.end());
+
+    for (Edge* e : loaded.get_edges()) {
+        int low = std::min(e->p1->label, e->p2->label);
+        int high = std::max(e->p1->label, e->p2->label);
+
+        if (low == 0) {
+            REQUIRE(e->weight == 0.5*(high/10));
+        } else {
+            REQUIRE(low == 30);
+            REQUIRE(high == 40);
+            REQUIRE(e->weight == 0.125);
+        }
+    }
+
+    SECTION("Corrupted files are rejected")
+    {
+        auto write_bytes = [&](const std::string& content) {
+            std::ofstream os(file_path, std::ios::binary);
+            os.write(content.data(), content.size());
+        };
+
+        size_t offsets_begin = sizeof(BinaryGraphHeader);
+        size_t targets_begin = bytes.size() - 5*sizeof(uint32_t);
+
+        // truncated, or with trailing bytes
+        write_bytes(bytes.substr(0, bytes.size() - 1));
+        REQUIRE_THROWS_AS(Graph(file_path), std::invalid_argument);
+
+        write_bytes(bytes + "x");
+        REQUIRE_THROWS_AS(Graph(file_path), std::invalid_argument);
+
+        // decreasing offsets
+        std::string corrupted = bytes;
+        uint64_t offset = 5;
+        std::memcpy(&corrupted[offsets_begin + sizeof(uint64_t)], &offset, sizeof(offset));
+        write_bytes(corrupted);
+        REQUIRE_THROWS_AS(Graph(file_path), std::invalid_argument);
+
+        // target out of range
+        corrupted = bytes;
+        uint32_t target = 5;
+        std::memcpy(&corrupted[targets_begin], &target, sizeof(target));
+        write_bytes(corrupted);
+        REQUIRE_THROWS_AS(Graph(file_path), std::invalid_argument);
+
+        std::remove(file_path.c_str());
+    }
+}
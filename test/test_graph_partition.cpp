@@ -0,0 +1,70 @@
+#include "catch.hpp"
+
+#include "../src/graph_partition.hpp"
+#include "../src/mst_kruskal.hpp"
+#include "../src/mst_prim_kumar.hpp"
+#include "../src/mst_distributed_boruvka.hpp"
+
+#include <mpi.h>
+#include <cstdio>
+
+TEST_CASE("Graph partitions with nodes listed only as neighbors", "[partition]")
+{
+    MPI_Init(NULL, NULL);
+
+    int rank, world_size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &world_size);
+
+    // nodes 1 and 5 have no row of their own
+    std::string file_path = "test_graph_partition_" + std::to_string(rank) + ".txt";
+    std::ofstream os(file_path);
+    os << "Test graph\n\n";
+    os << "2 (1)  [1, 3, 4]\n";
+    os << "3 (1)  [2, 4]\n";
+    os << "4 (1)  [2, 3, 5]\n";
+    os.close();
+
+    GraphPartition partition = GraphPartition(file_path, rank, world_size);
+    Graph graph = Graph(file_path);
+    std::remove(file_path.c_str());
+
+    // every node is owned by a single processor, with all its edges
+    int n_owned = partition.get_owned_nodes().size();
+    int m_owned = partition.get_owned_edges().size();
+    int n, m;
+    MPI_Allreduce(&n_owned, &n, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(&m_owned, &m, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+    REQUIRE(n == 5);
+    REQUIRE(m == 5);
+
+    std::unordered_map<int, int> degrees;
+    for (Node* node : graph.get_nodes()) {
+        degrees[node->label] = graph.connected_edges(node).size();
+    }
+
+    for (Node* node : partition.get_owned_nodes()) {
+        int degree = partition.get_graph()->connected_edges(node).size();
+        REQUIRE(degree == degrees.at(node->label));
+    }
+
+    // the distributed algorithms find the same MST as the sequential ones
+    KruskalAlgorithm kruskal = KruskalAlgorithm(&graph);
+    kruskal.compute_mst();
+
+    PrimKumarAlgorithm prim_kumar = PrimKumarAlgorithm(&partition);
+    prim_kumar.compute_mst();
+
+    PrimKumarAlgorithm hybrid = PrimKumarAlgorithm(&partition, 2);
+    hybrid.compute_mst();
+
+    DistributedBoruvkaAlgorithm boruvka = DistributedBoruvkaAlgorithm(&partition);
+    boruvka.compute_mst();
+
+    REQUIRE(std::abs(prim_kumar.get_mst_weight() - kruskal.get_mst_weight()) < 1e-9);
+    REQUIRE(std::abs(hybrid.get_mst_weight() - kruskal.get_mst_weight()) < 1e-9);
+    REQUIRE(std::abs(boruvka.get_mst_weight() - kruskal.get_mst_weight()) < 1e-9);
+
+    MPI_Finalize();
+}
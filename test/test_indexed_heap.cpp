@@ -0,0 +1,105 @@
+#include "catch.hpp"
+
+#include "../src/indexed_heap.hpp"
+
+#include <random>
+#include <algorithm>
+
+TEST_CASE("Basic tests for the indexed heap", "[heap:base]")
+{
+    IndexedHeap heap = IndexedHeap(10);
+
+    SECTION("Empty heap")
+    {
+        REQUIRE(heap.empty() == true);
+        REQUIRE(heap.size() == 0);
+
+        for (int i = 0; i < 10; i ++) {
+            REQUIRE(heap.contains(i) == false);
+        }
+    }
+
+    SECTION("Push and pop")
+    {
+        heap.push(3, 5.0);
+        heap.push(7, 1.0);
+        heap.push(1, 3.0);
+
+        REQUIRE(heap.size() == 3);
+        REQUIRE(heap.contains(7) == true);
+        REQUIRE(heap.get_key(1) == 3.0);
+
+        REQUIRE(heap.top() == 7);
+        heap.pop();
+
+        REQUIRE(heap.contains(7) == false);
+        REQUIRE(heap.top() == 1);
+        heap.pop();
+
+        REQUIRE(heap.top() == 3);
+        heap.pop();
+
+        REQUIRE(heap.empty() == true);
+    }
+
+    SECTION("Decrease key")
+    {
+        heap.push(0, 4.0);
+        heap.push(1, 3.0);
+        heap.push(2, 2.0);
+
+        heap.decrease_key(0, 1.0);
+        REQUIRE(heap.top() == 0);
+        REQUIRE(heap.get_key(0) == 1.0);
+
+        // larger keys are ignored, smaller ones are applied
+        REQUIRE(heap.push_or_decrease(1, 10.0) == false);
+        REQUIRE(heap.push_or_decrease(1, 0.5) == true);
+        REQUIRE(heap.top() == 1);
+
+        // absent identifiers are inserted
+        REQUIRE(heap.push_or_decrease(9, 0.1) == true);
+        REQUIRE(heap.top() == 9);
+    }
+
+    SECTION("Equal keys are ordered by identifier")
+    {
+        heap.push(5, 1.0);
+        heap.push(2, 1.0);
+        heap.push(8, 1.0);
+
+        REQUIRE(heap.top() == 2);
+        heap.pop();
+        REQUIRE(heap.top() == 5);
+    }
+}
+
+TEST_CASE("Heap sort with random decrease-keys", "[heap:random]")
+{
+    int n = 1000;
+    std::mt19937 gen(3);
+    std::uniform_real_distribution<double> distribution(0.0, 100.0);
+
+    IndexedHeap heap = IndexedHeap(n);
+    std::vector<double> keys(n);
+
+    for (int i = 0; i < n; i ++) {
+        keys[i] = distribution(gen);
+        heap.push(i, keys[i]);
+    }
+
+    for (int i = 0; i < n; i += 3) {
+        keys[i] /= 2;
+        heap.decrease_key(i, keys[i]);
+    }
+
+    std::vector<double> popped;
+    while (!heap.empty()) {
+        popped.push_back(keys[heap.top()]);
+        heap.pop();
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    REQUIRE(popped == keys);
+}
@@ -0,0 +1,247 @@
+#include "catch.hpp"
+
+#include "../src/kmeans.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_CASE("Bound-accelerated kmeans", "[kmeans:bounds]")
+{
+    int n = 2000;
+
+    for (int d : {3, 7}) {
+        for (int k : {5, 60}) {
+
+            // blobs around a few random centers, with some noise
+            std::srand(d*100 + k);
+            std::vector<double> coords(n*d);
+            for (int i = 0; i < n; i ++) {
+                int blob = i % 8;
+                for (int j = 0; j < d; j ++) {
+                    coords[i*d + j] = 10.0 * ((blob * 7 + j * 3) % 11) + (double) std::rand() / RAND_MAX;
+                }
+            }
+            PointSet point_set(coords, n, d);
+
+            std::srand(42);
+            Cloud lloyd(&point_set, k);
+            lloyd.kmeans(KMeansMode::Lloyd);
+
+            for (KMeansMode mode : {KMeansMode::Hamerly, KMeansMode::Elkan}) {
+                std::srand(42);
+                Cloud cloud(&point_set, k);
+                cloud.kmeans(mode);
+
+                int different_labels = 0;
+                for (int i = 0; i < n; i ++) {
+                    different_labels += (cloud.get_point(i).label != lloyd.get_point(i).label);
+                }
+                REQUIRE(different_labels == 0);
+
+                for (int j = 0; j < k; j ++) {
+                    for (int l = 0; l < d; l ++) {
+                        REQUIRE(cloud.get_center(j).coords[l] == Approx(lloyd.get_center(j).coords[l]));
+                    }
+                }
+
+                REQUIRE(cloud.intracluster_variance() == Approx(lloyd.intracluster_variance()));
+            }
+        }
+    }
+}
+
+TEST_CASE("Multithreaded kmeans", "[kmeans:threads]")
+{
+    // enough points for several blocks
+    int n = 5 * KMEANS_POINTS_PER_BLOCK + 17;
+    int d = 5;
+    int k = 12;
+
+    std::srand(3);
+    std::vector<double> coords(n*d);
+    for (int i = 0; i < n; i ++) {
+        for (int j = 0; j < d; j ++) {
+            coords[i*d + j] = (double) std::rand() / RAND_MAX;
+        }
+    }
+    PointSet point_set(coords, n, d);
+
+    for (KMeansMode mode : {KMeansMode::Lloyd, KMeansMode::Hamerly, KMeansMode::Elkan}) {
+        std::srand(5);
+        Cloud serial(&point_set, k, 1);
+        serial.kmeans(mode);
+
+        std::srand(5);
+        Cloud parallel(&point_set, k, 4);
+        parallel.kmeans(mode);
+
+        int different_labels = 0;
+        for (int i = 0; i < n; i ++) {
+            different_labels += (parallel.get_point(i).label != serial.get_point(i).label);
+        }
+        REQUIRE(different_labels == 0);
+
+        for (int j = 0; j < k; j ++) {
+            for (int l = 0; l < d; l ++) {
+                REQUIRE(parallel.get_center(j).coords[l] == Approx(serial.get_center(j).coords[l]));
+            }
+        }
+    }
+}
+
+TEST_CASE("kmeans++ and kmeans|| initializations", "[kmeans:init]")
+{
+    // blobs far away from each other, which D^2 sampling should all hit
+    int n = 3 * KMEANS_POINTS_PER_BLOCK;
+    int d = 3;
+    int k = 20;
+
+    std::srand(11);
+    std::vector<double> coords(n*d);
+    for (int i = 0; i < n; i ++) {
+        int blob = i % k;
+        for (int j = 0; j < d; j ++) {
+            coords[i*d + j] = 1000.0 * (j == blob % d) * (1 + blob / d) + (double) std::rand() / RAND_MAX;
+        }
+    }
+    PointSet point_set(coords, n, d);
+
+    auto blob_of = [&](Point& center) {
+        for (int blob = 0; blob < k; blob ++) {
+            double dist = 0.0;
+            for (int j = 0; j < d; j ++) {
+                double diff = center.coords[j] - coords[blob*d + j];
+                dist += diff*diff;
+            }
+            if (dist < 3.0) {
+                return blob;
+            }
+        }
+        return -1;
+    };
+
+    for (int num_threads : {1, 3}) {
+        for (bool parallel_init : {false, true}) {
+            Cloud cloud(&point_set, k, num_threads);
+            if (parallel_init) {
+                cloud.init_parallel();
+            } else {
+                cloud.init_plusplus();
+            }
+
+            std::vector<int> centers_per_blob(k, 0);
+            for (int j = 0; j < k; j ++) {
+                int blob = blob_of(cloud.get_center(j));
+                REQUIRE(blob >= 0);
+                centers_per_blob[blob] += 1;
+            }
+            REQUIRE(std::count(centers_per_blob.begin(), centers_per_blob.end(), 1) == k);
+        }
+    }
+}
+
+TEST_CASE("Mini-batch and streaming kmeans", "[kmeans:minibatch]")
+{
+    // eight well separated blobs
+    int n = 8000;
+    int d = 4;
+    int k = 8;
+
+    std::srand(7);
+    std::vector<double> coords(n*d);
+    for (int i = 0; i < n; i ++) {
+        int blob = i % 8;
+        for (int j = 0; j < d; j ++) {
+            coords[i*d + j] = 10.0 * ((blob >> (j % 3)) & 1) + 10.0 * (j == 3) * (blob % 3) + (double) std::rand() / RAND_MAX;
+        }
+    }
+    PointSet point_set(coords, n, d);
+
+    // the variance once Lloyd's iterations are run from the given centers, 
+    // which should barely improve it
+    auto refined_variance = [&](Cloud& approx) {
+        Cloud cloud(&point_set, k);
+        for (int j = 0; j < k; j ++) {
+            cloud.set_center(approx.get_center(j), j);
+        }
+        while (cloud.set_voronoi_labels() > 0) {
+            cloud.set_centroid_centers();
+        }
+        return cloud.intracluster_variance();
+    };
+
+    SECTION("Mini-batch kmeans is close to Lloyd's")
+    {
+        std::srand(1);
+        Cloud cloud(&point_set, k);
+        cloud.kmeans(KMeansMode::MiniBatch);
+
+        REQUIRE(cloud.intracluster_variance() <= 1.05 * refined_variance(cloud));
+    }
+
+    SECTION("Streaming kmeans reads chunks of the file")
+    {
+        std::string file_path = "test_kmeans_stream.txt";
+        std::ofstream file(file_path);
+        file.precision(17);
+        for (int i = 0; i < n; i ++) {
+            for (int j = 0; j < d; j ++) {
+                file << coords[i*d + j] << (j + 1 < d ? " " : "\n");
+            }
+        }
+        file.close();
+
+        PointStream stream(file_path);
+        REQUIRE(stream.get_dim() == d);
+
+        std::srand(1);
+        Cloud cloud(d, 1500, k);
+        cloud.kmeans_stream(stream);
+
+        // the cloud holds the first chunk, labelled with the nearest centers
+        REQUIRE(cloud.get_n() == 1500);
+        for (int i = 0; i < cloud.get_n(); i ++) {
+            for (int j = 0; j < d; j ++) {
+                REQUIRE(cloud.get_point(i).coords[j] == coords[i*d + j]);
+            }
+        }
+
+        // the centers fit the whole file
+        Cloud all(&point_set, k);
+        for (int j = 0; j < k; j ++) {
+            all.set_center(cloud.get_center(j), j);
+        }
+        all.set_voronoi_labels();
+        REQUIRE(all.intracluster_variance() <= 1.05 * refined_variance(cloud));
+
+        std::remove(file_path.c_str());
+    }
+}
+
+TEST_CASE("Files without a dimension are rejected", "[kmeans:stream]")
+{
+    std::string file_path = "test_kmeans_no_dimension.txt";
+
+    SECTION("Empty file")
+    {
+        std::ofstream file(file_path);
+        file.close();
+
+        REQUIRE_THROWS_AS(PointStream(file_path), std::invalid_argument);
+    }
+
+    SECTION("Blank first row")
+    {
+        std::ofstream file(file_path);
+        file << " \t\n1.0 2.0\n";
+        file.close();
+
+        REQUIRE_THROWS_AS(PointStream(file_path), std::invalid_argument);
+    }
+
+    std::remove(file_path.c_str());
+}
@@ -4,6 +4,14 @@
 #include "../src/mst_prim.hpp"
 #include "../src/mst_boruvka.hpp"
 #include "../src/mst_kruskal.hpp"
+#include "../src/mst_filter_kruskal.hpp"
+#include "../src/mst_dense_prim.hpp"
+#include "../src/mst_euclidean_boruvka.hpp"
+#include "../src/radix_sort.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
 
 TEST_CASE("First test for MST construction")
 {
@@ -97,6 +105,21 @@ TEST_CASE("First test for MST construction")
         REQUIRE(needed_edge == true); 
     }
 
+    SECTION("Filter-Kruskal's algorithm")
+    {
+        FilterKruskalAlgorithm filter_kruskal = FilterKruskalAlgorithm(&g);
+        filter_kruskal.compute_mst();
+
+        REQUIRE(std::abs(filter_kruskal.get_mst_graph()->total_weight() - 15) < 0.001);
+
+        std::unordered_set<Edge*> mst_edges = filter_kruskal.get_mst_graph()->get_edges();
+
+        REQUIRE(mst_edges.size() == 6);
+        REQUIRE(mst_edges.find(my_edges[1]) != mst_edges.end());  // Edge 1<-1->3
+        REQUIRE(mst_edges.find(my_edges[4]) != mst_edges.end());  // Edge 2<-4->6
+        REQUIRE(mst_edges.find(my_edges[5]) == mst_edges.end());  // Edge 3<-9->4
+    }
+
     SECTION("Kruskal's algorithm")
     {
         KruskalAlgorithm kruskal = KruskalAlgorithm(&g);
@@ -239,6 +262,35 @@ TEST_CASE("Second test for MST construction")
         REQUIRE(mst_edges.find(my_edges[13]) == mst_edges.end()); // Edge 7<-7->8
     }
 
+    SECTION("Filter-Kruskal's algorithm")
+    {
+        FilterKruskalAlgorithm filter_kruskal = FilterKruskalAlgorithm(&g);
+        filter_kruskal.compute_mst();
+
+        REQUIRE(std::abs(filter_kruskal.get_mst_graph()->total_weight() - 37) < 0.001);
+
+        std::unordered_set<Edge*> mst_edges = filter_kruskal.get_mst_graph()->get_edges();
+
+        REQUIRE(mst_edges.size() == 8);
+        REQUIRE(mst_edges.find(my_edges[2]) != mst_edges.end()); // Edge 1<-8->2
+        REQUIRE(mst_edges.find(my_edges[3]) == mst_edges.end()); // Edge 1<-11->7
+        REQUIRE(mst_edges.find(my_edges[7]) != mst_edges.end()); // Edge 3<-9->4
+    }
+
+    SECTION("Kruskal's algorithm with a priority queue")
+    {
+        KruskalAlgorithm kruskal = KruskalAlgorithm(&g, KruskalMode::PriorityQueue);
+        kruskal.compute_mst();
+
+        REQUIRE(std::abs(kruskal.get_mst_graph()->total_weight() - 37) < 0.001);
+
+        std::unordered_set<Edge*> mst_edges = kruskal.get_mst_graph()->get_edges();
+
+        REQUIRE(mst_edges.size() == 8);
+        REQUIRE(mst_edges.find(my_edges[3]) == mst_edges.end()); // Edge 1<-11->7
+        REQUIRE(mst_edges.find(my_edges[7]) != mst_edges.end()); // Edge 3<-9->4
+    }
+
     SECTION("Kruskal's algorithm")
     {
         KruskalAlgorithm kruskal = KruskalAlgorithm(&g);
@@ -293,4 +345,250 @@ TEST_CASE("Second test for MST construction")
             REQUIRE(clustering_k3.at(my_nodes[7]) == my_nodes[7]);
         }
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("MST algorithms agree on a dense random graph", "[mst:dense]")
+{
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+    // complete graph on 120 nodes, that is 7140 edges
+    int n = 120;
+    std::vector<Node*> my_nodes;
+    for (int i = 0; i < n; i ++) {
+        my_nodes.push_back(new Node(i));
+    }
+
+    Graph g;
+    for (int i = 0; i < n; i ++) {
+        for (int j = i+1; j < n; j ++) {
+            g.add_edge(new Edge(my_nodes[i], my_nodes[j], distribution(gen)));
+        }
+    }
+
+    KruskalAlgorithm kruskal = KruskalAlgorithm(&g, KruskalMode::PriorityQueue);
+    kruskal.compute_mst();
+    double expected_weight = kruskal.get_mst_weight();
+
+    SECTION("Kruskal's algorithm with a sort")
+    {
+        KruskalAlgorithm sorted_kruskal = KruskalAlgorithm(&g);
+        sorted_kruskal.compute_mst();
+
+        REQUIRE(std::abs(sorted_kruskal.get_mst_weight() - expected_weight) < 1e-9);
+        REQUIRE(sorted_kruskal.get_mst_graph()->get_number_of_edges() == n-1);
+    }
+
+    SECTION("Filter-Kruskal's algorithm")
+    {
+        FilterKruskalAlgorithm filter_kruskal = FilterKruskalAlgorithm(&g);
+        filter_kruskal.compute_mst();
+
+        REQUIRE(std::abs(filter_kruskal.get_mst_weight() - expected_weight) < 1e-9);
+        REQUIRE(filter_kruskal.get_mst_graph()->get_number_of_edges() == n-1);
+    }
+
+    SECTION("Prim's algorithm")
+    {
+        PrimAlgorithm prim = PrimAlgorithm(&g);
+        prim.compute_mst();
+
+        REQUIRE(std::abs(prim.get_mst_weight() - expected_weight) < 1e-9);
+    }
+
+    SECTION("Boruvka's algorithm")
+    {
+        BoruvkaAlgorithm boruvka = BoruvkaAlgorithm(&g, 1);
+        boruvka.compute_mst();
+
+        REQUIRE(std::abs(boruvka.get_mst_weight() - expected_weight) < 1e-9);
+    }
+
+    SECTION("Parallel Boruvka's algorithm")
+    {
+        BoruvkaAlgorithm boruvka = BoruvkaAlgorithm(&g, 4);
+        boruvka.compute_mst();
+
+        REQUIRE(std::abs(boruvka.get_mst_weight() - expected_weight) < 1e-9);
+        REQUIRE(boruvka.get_mst_graph()->get_number_of_edges() == n-1);
+    }
+
+    SECTION("Boruvka's algorithm with parallel edges")
+    {
+        // a heavier copy of each edge, which contraction must drop
+        Graph multigraph;
+        for (Edge* e : g.get_edges()) {
+            multigraph.add_edge(e);
+            multigraph.add_edge(new Edge(e->p1, e->p2, e->weight + 1.0));
+        }
+
+        BoruvkaAlgorithm boruvka = BoruvkaAlgorithm(&multigraph, 2);
+        boruvka.compute_mst();
+
+        REQUIRE(std::abs(boruvka.get_mst_weight() - expected_weight) < 1e-9);
+        REQUIRE(boruvka.get_mst_graph()->get_number_of_edges() == n-1);
+    }
+}
+
+TEST_CASE("Contraction of the edges between Boruvka's rounds", "[mst:contract]")
+{
+    std::mt19937 gen(11);
+
+    // many edges per component, so that several threads share every pass
+    int n = 200;
+    int k = 37;
+    int m = 20000;
+
+    std::vector<node_id_t> label(n);
+    for (int u = 0; u < n; u ++) {
+        label[u] = gen() % k;
+    }
+
+    std::vector<WeightedEdge> edges(m);
+    for (int i = 0; i < m; i ++) {
+        edges[i] = {(edge_weight_t) i, (node_id_t) (gen() % n), (node_id_t) (gen() % n), i};
+    }
+
+    // the first edge between each pair of distinct components, in order
+    std::vector<WeightedEdge> expected;
+    std::set<std::pair<node_id_t, node_id_t>> linked;
+    for (WeightedEdge e : edges) {
+        e.u = label[e.u];
+        e.v = label[e.v];
+        if (e.u != e.v && linked.insert({std::min(e.u, e.v), std::max(e.u, e.v)}).second) {
+            expected.push_back(e);
+        }
+    }
+
+    for (int num_threads : {1, 3, 4}) {
+        ThreadPool pool(num_threads);
+        std::vector<WeightedEdge> contracted = edges;
+        BoruvkaAlgorithm::contract_edges(contracted, label, k, pool);
+
+        REQUIRE(contracted.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); i ++) {
+            REQUIRE(contracted[i].id == expected[i].id);
+            REQUIRE(contracted[i].u == expected[i].u);
+            REQUIRE(contracted[i].v == expected[i].v);
+        }
+    }
+}
+
+TEST_CASE("MST of a set of points without building the complete graph", "[mst:points]")
+{
+    Point::d = 3;
+
+    std::mt19937 gen(11);
+    std::normal_distribution<double> distribution(0.0, 1.0);
+
+    int n = 150;
+    std::vector<Point*> points;
+    for (int i = 0; i < n; i ++) {
+        Point* p = new Point();
+        for (int j = 0; j < 3; j ++) {
+            // three well separated blobs
+            p->coords[j] = distribution(gen) + 100*(i % 3);
+        }
+        points.push_back(p);
+    }
+
+    Graph g = Graph(points);
+    KruskalAlgorithm kruskal = KruskalAlgorithm(&g);
+    kruskal.compute_mst();
+
+    DensePrimAlgorithm dense_prim = DensePrimAlgorithm(points);
+    dense_prim.compute_mst();
+
+    SECTION("Same MST as on the complete graph")
+    {
+        REQUIRE(dense_prim.get_initial_graph() == NULL);
+        REQUIRE(dense_prim.get_mst_graph()->get_number_of_nodes() == n);
+        REQUIRE(dense_prim.get_mst_graph()->get_number_of_edges() == n-1);
+        REQUIRE(std::abs(dense_prim.get_mst_weight() - kruskal.get_mst_weight()) < 1e-6);
+        REQUIRE(std::abs(dense_prim.get_mst_graph()->total_weight() - kruskal.get_mst_weight()) < 1e-6);
+    }
+
+    SECTION("Same MST with dual-tree Boruvka")
+    {
+        // small leaves in order to go through all the cases of the traversal
+        EuclideanBoruvkaAlgorithm euclidean_boruvka = EuclideanBoruvkaAlgorithm(points, 4);
+        euclidean_boruvka.compute_mst();
+
+        REQUIRE(euclidean_boruvka.get_initial_graph() == NULL);
+        REQUIRE(euclidean_boruvka.get_mst_graph()->get_number_of_nodes() == n);
+        REQUIRE(euclidean_boruvka.get_mst_graph()->get_number_of_edges() == n-1);
+        REQUIRE(std::abs(euclidean_boruvka.get_mst_weight() - kruskal.get_mst_weight()) < 1e-6);
+    }
+
+    SECTION("Dual-tree Boruvka with duplicated points")
+    {
+        std::vector<Point*> duplicated = points;
+        for (int i = 0; i < 40; i ++) {
+            duplicated.push_back(points[i % 5]);
+        }
+
+        Graph g_duplicated = Graph(duplicated);
+        KruskalAlgorithm kruskal_duplicated = KruskalAlgorithm(&g_duplicated);
+        kruskal_duplicated.compute_mst();
+
+        EuclideanBoruvkaAlgorithm euclidean_boruvka = EuclideanBoruvkaAlgorithm(duplicated, 8);
+        euclidean_boruvka.compute_mst();
+
+        REQUIRE(euclidean_boruvka.get_mst_graph()->get_number_of_edges() == n+40-1);
+        REQUIRE(std::abs(euclidean_boruvka.get_mst_weight() - kruskal_duplicated.get_mst_weight()) < 1e-6);
+    }
+
+    SECTION("Clustering recovers the blobs")
+    {
+        std::unordered_map<Node*, Node*> clusters = dense_prim.compute_clustering(3);
+
+        REQUIRE(clusters.size() == (unsigned int)n);
+
+        int well_clustered = 0;
+        for (auto kv1 : clusters) {
+            for (auto kv2 : clusters) {
+                bool same_blob = (kv1.first->label % 3) == (kv2.first->label % 3);
+                well_clustered += (same_blob == (kv1.second == kv2.second));
+            }
+        }
+
+        REQUIRE(well_clustered == n*n);
+    }
+}
+
+TEST_CASE("Radix sort of flat edges", "[mst:sort]")
+{
+    std::mt19937 gen(42);
+    std::exponential_distribution<double> distribution(1);
+
+    SECTION("Keys preserve the order of weights")
+    {
+        REQUIRE(weight_sort_key(-2.0) < weight_sort_key(-1.0));
+        REQUIRE(weight_sort_key(-1.0) < weight_sort_key(0.0));
+        REQUIRE(weight_sort_key(0.0) < weight_sort_key(0.5));
+        REQUIRE(weight_sort_key(0.5) < weight_sort_key(3.0));
+    }
+
+    SECTION("Sorting a large array of edges")
+    {
+        std::vector<WeightedEdge> edges(5000);
+        for (int i = 0; i < 5000; i ++) {
+            // a few negative weights and many duplicates
+            double w = (i % 7 == 0) ? -distribution(gen) : (double)(int)(10*distribution(gen));
+            edges[i] = WeightedEdge{w, i, i+1, i};
+        }
+
+        std::vector<WeightedEdge> expected = edges;
+        std::stable_sort(expected.begin(), expected.end(), 
+            [](const WeightedEdge& e1, const WeightedEdge& e2) { return e1.weight < e2.weight; });
+
+        radix_sort_edges(edges);
+
+        int same_position = 0;
+        for (int i = 0; i < 5000; i ++) {
+            same_position += (edges[i].id == expected[i].id);
+        }
+
+        REQUIRE(same_position == 5000);
+    }
+}
@@ -1,6 +1,14 @@
 #include "catch.hpp"
 
 #include "../src/point.hpp"
+#include "../src/point_set.hpp"
+#include "../src/distance.hpp"
+#include "../src/pairwise.hpp"
+#include "../src/silhouette.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 
 TEST_CASE("Simple point initialization", "[point:init]")
 {
@@ -49,4 +57,307 @@ TEST_CASE("Computation of distances between points", "[point:dist]")
     double d = p1.distance(&p2);
 
     REQUIRE((d - 2.828) < 0.001);
-}
\ No newline at end of file
+    REQUIRE(p1.squared_distance(&p2) == 8);
+}
+
+TEST_CASE("Vectorized distance kernels", "[point:kernel]")
+{
+    std::vector<DistanceKernels> kernels = supported_distance_kernels();
+
+    REQUIRE(std::string(kernels.front().name) == "scalar");
+    REQUIRE(std::string(kernels.back().name) == distance_kernel_name());
+
+    // dimensions covering full vectors and every possible tail, and row
+    // counts covering no row, full blocks and partial ones
+    for (const DistanceKernels& kernel : kernels) {
+        for (int d = 1; d <= 40; d ++) {
+            for (int count : {0, 1, 3, 8, 11}) {
+                std::vector<double> x(d);
+                std::vector<double> rows(count*d);
+
+                for (int j = 0; j < d; j ++) {
+                    x[j] = 0.5*j - 1;
+                }
+                for (int l = 0; l < count*d; l ++) {
+                    rows[l] = (l % 7) - 0.25*l;
+                }
+
+                std::vector<double> out(count + 1, -1.0);
+                kernel.one_to_many(x.data(), rows.data(), count, d, out.data());
+
+                for (int i = 0; i < count; i ++) {
+                    double expected = 0.0;
+                    for (int j = 0; j < d; j ++) {
+                        expected += (x[j] - rows[i*d+j]) * (x[j] - rows[i*d+j]);
+                    }
+
+                    INFO(kernel.name << " d=" << d << " count=" << count << " row=" << i);
+                    REQUIRE(std::abs(kernel.one_to_one(x.data(), &rows[i*d], d) - expected) <= 1e-12 * expected);
+                    REQUIRE(std::abs(out[i] - expected) <= 1e-12 * expected);
+                    REQUIRE(std::abs(squared_distance(x.data(), &rows[i*d], d) - expected) <= 1e-12 * expected);
+                }
+
+                // nothing is written past the last row
+                REQUIRE(out[count] == -1.0);
+            }
+        }
+    }
+}
+
+TEST_CASE("Tiled pairwise distances", "[point:pairwise]")
+{
+    // sizes which are not multiples of the tile size, far from the origin
+    int n = 300;
+    int m = 140;
+    int d = 7;
+
+    std::vector<double> x(n*d);
+    std::vector<double> y(m*d);
+    for (int l = 0; l < n*d; l ++) {
+        x[l] = 1000 + std::sin(l);
+    }
+    for (int l = 0; l < m*d; l ++) {
+        y[l] = 1000 + std::cos(l);
+    }
+
+    // a duplicated point
+    std::copy(x.begin(), x.begin() + d, x.begin() + 250*d);
+
+    SECTION("Between two sets, each pair is seen once")
+    {
+        std::vector<int> seen(n*m, 0);
+        double max_error = 0.0;
+
+        pairwise_squared_distances(x.data(), n, y.data(), m, d, [&](int row_begin, int row_end, int col_begin, int col_end, const double* tile) {
+            for (int i = row_begin; i < row_end; i ++) {
+                for (int j = col_begin; j < col_end; j ++) {
+                    double expected = squared_distance(&x[i*d], &y[j*d], d);
+                    double dist = tile[(i - row_begin)*PAIRWISE_TILE_SIZE + (j - col_begin)];
+
+                    max_error = std::max(max_error, std::abs(dist - expected) / expected);
+                    seen[i*m + j] += 1;
+                }
+            }
+        });
+
+        REQUIRE(max_error < 1e-9);
+        REQUIRE(std::count(seen.begin(), seen.end(), 1) == n*m);
+    }
+
+    SECTION("Within a set, the upper triangle is covered")
+    {
+        std::vector<int> seen(n*n, 0);
+        double max_error = 0.0;
+
+        pairwise_squared_distances(x.data(), n, d, [&](int row_begin, int row_end, int col_begin, int col_end, const double* tile) {
+            for (int i = row_begin; i < row_end; i ++) {
+                for (int j = std::max(col_begin, i+1); j < col_end; j ++) {
+                    double expected = squared_distance(&x[i*d], &x[j*d], d);
+                    double dist = tile[(i - row_begin)*PAIRWISE_TILE_SIZE + (j - col_begin)];
+
+                    if (expected == 0) {
+                        REQUIRE(dist == 0);
+                    } else {
+                        max_error = std::max(max_error, std::abs(dist - expected) / expected);
+                    }
+                    seen[i*n + j] += 1;
+                }
+            }
+        });
+
+        REQUIRE(max_error < 1e-9);
+        REQUIRE(std::count(seen.begin(), seen.end(), 1) == n*(n-1)/2);
+    }
+}
+
+TEST_CASE("Silhouette of a clustering", "[point:silhouette]")
+{
+    // enough points for several threads, with an empty and a singleton cluster
+    int n = 3 * SILHOUETTE_MIN_ROWS + 11;
+    int d = 3;
+    int k = 6;
+
+    std::vector<double> coords(n*d);
+    std::vector<int> labels(n);
+    for (int i = 0; i < n; i ++) {
+        labels[i] = (i == 7) ? 5 : (i * 7) % 4;
+        for (int j = 0; j < d; j ++) {
+            coords[i*d + j] = 3.0 * labels[i] + std::sin(i * 1.3 + j);
+        }
+    }
+
+    // the definition, pair by pair
+    double expected = 0.0;
+    for (int i = 0; i < n; i ++) {
+        std::vector<double> sums(k, 0.0);
+        std::vector<int> sizes(k, 0);
+        for (int j = 0; j < n; j ++) {
+            if (j != i) {
+                sums[labels[j]] += std::sqrt(squared_distance(&coords[i*d], &coords[j*d], d));
+                sizes[labels[j]] += 1;
+            }
+        }
+
+        if (sizes[labels[i]] == 0) {
+            continue;
+        }
+
+        double a = sums[labels[i]] / sizes[labels[i]];
+        double b = 1e300;
+        for (int c = 0; c < k; c ++) {
+            if (c != labels[i] && sizes[c] > 0) {
+                b = std::min(b, sums[c] / sizes[c]);
+            }
+        }
+        expected += (b - a) / std::max(a, b);
+    }
+    expected /= n;
+
+    for (int num_threads : {1, 2, 3}) {
+        REQUIRE(silhouette_score(coords.data(), labels.data(), n, d, k, num_threads) == Approx(expected).epsilon(1e-10));
+    }
+
+    SECTION("Sampled silhouette")
+    {
+        std::srand(9);
+        SilhouetteEstimate estimate = sampled_silhouette_score(coords.data(), labels.data(), n, d, k, 300, 2);
+
+        // each of the 5 non-empty clusters gets its share of the 300 points
+        // rounded, hence up to half a point less, and at least two points
+        // (one for the singleton), hence up to two points more
+        REQUIRE(estimate.sample_size >= 300 - 2);
+        REQUIRE(estimate.sample_size <= 300 + 5 * 2);
+        REQUIRE(estimate.half_width > 0);
+        REQUIRE(std::abs(estimate.value - expected) <= 2 * estimate.half_width);
+
+        // two points at least from each cluster which has them, so that
+        // tiny samples still have a variance
+        SilhouetteEstimate tiny = sampled_silhouette_score(coords.data(), labels.data(), n, d, k, 1, 2);
+        REQUIRE(tiny.sample_size == 4 * 2 + 1);
+        REQUIRE(tiny.half_width > 0);
+
+        SilhouetteEstimate exact = sampled_silhouette_score(coords.data(), labels.data(), n, d, k, n);
+        REQUIRE(exact.value == Approx(expected).epsilon(1e-10));
+        REQUIRE(exact.half_width == 0.0);
+    }
+
+    // the threads share one n*k array of sums, which stays race-free as long
+    // as the pairs of blocks run together never share a block
+    for (int num_blocks = 1; num_blocks <= 9; num_blocks ++) {
+        std::vector<std::vector<int>> seen(num_blocks, std::vector<int>(num_blocks, 0));
+
+        for (const std::vector<std::pair<int, int>>& round : silhouette_block_rounds(num_blocks)) {
+            std::vector<int> used(num_blocks, 0);
+            for (const std::pair<int, int>& pair : round) {
+                REQUIRE(pair.first <= pair.second);
+                seen[pair.first][pair.second] += 1;
+                used[pair.first] += 1;
+                if (pair.second != pair.first) {
+                    used[pair.second] += 1;
+                }
+            }
+            for (int a = 0; a < num_blocks; a ++) {
+                REQUIRE(used[a] <= 1);
+            }
+        }
+
+        // each distance is computed once
+        for (int a = 0; a < num_blocks; a ++) {
+            for (int b = a; b < num_blocks; b ++) {
+                REQUIRE(seen[a][b] == 1);
+            }
+        }
+    }
+
+    // a single cluster has no silhouette
+    std::vector<int> same_labels(n, 0);
+    REQUIRE(silhouette_score(coords.data(), same_labels.data(), n, d, 1) == 0.0);
+}
+
+TEST_CASE("Sets of points with contiguous storage", "[point:set]")
+{
+    Point::d = 2;
+
+    std::vector<double> coords = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    PointSet set(coords, 3, 3);
+
+    SECTION("Rows are contiguous and aligned")
+    {
+        REQUIRE(set.size() == 3);
+        REQUIRE(set.get_dim() == 3);
+        REQUIRE(reinterpret_cast<uintptr_t>(set.get_data()) % POINT_SET_ALIGNMENT == 0);
+        REQUIRE(set.row(1) == set.get_data() + 3);
+        REQUIRE(set.row(2)[1] == 7);
+    }
+
+    SECTION("Column-major view")
+    {
+        REQUIRE(!set.has_columns());
+
+        set.build_columns();
+
+        REQUIRE(set.has_columns());
+        REQUIRE(set.column(0)[2] == 6);
+        REQUIRE(set.column(2)[1] == 5);
+    }
+
+    SECTION("Points view the set, whatever the static dimension")
+    {
+        std::vector<Point*> points = set.make_points();
+
+        REQUIRE(points[1]->get_dim() == 3);
+        REQUIRE(points[1]->coords == set.row(1));
+
+        set.row(2)[0] = 3;
+        REQUIRE(points[2]->coords[0] == 3);
+        REQUIRE(std::abs(points[0]->distance(points[1]) - std::sqrt(27.0)) < 1e-12);
+
+        for (Point* p : points) {
+            delete p;
+        }
+    }
+}
+
+TEST_CASE("Reading points from a file", "[point:read]")
+{
+    std::string file_path = "test_points.txt";
+
+    SECTION("Rows are read in order, without a spurious last point")
+    {
+        // blank row, and no newline at the end of the file
+        std::ofstream os(file_path);
+        os << "1.5 -2 3e-1\n4 5 6\n\n-7.25 8 9";
+        os.close();
+
+        for (int num_threads = 1; num_threads <= 4; num_threads ++) {
+            int n, d;
+            std::vector<double> coords = Point::read_coords_from_file(file_path, n, d, num_threads);
+
+            REQUIRE(n == 3);
+            REQUIRE(d == 3);
+            REQUIRE(coords.size() == 9);
+            REQUIRE(coords[0] == 1.5);
+            REQUIRE(coords[2] == 0.3);
+            REQUIRE(coords[6] == -7.25);
+            REQUIRE(coords[8] == 9);
+        }
+
+        std::vector<Point*> points = Point::read_points_from_file(file_path);
+
+        REQUIRE(points.size() == 3);
+        REQUIRE(Point::d == 3);
+        REQUIRE(points[1]->coords[1] == 5);
+    }
+
+    SECTION("Malformed rows are reported")
+    {
+        std::ofstream os(file_path);
+        os << "1 2\n3 x\n";
+        os.close();
+
+        int n, d;
+        REQUIRE_THROWS_AS(Point::read_coords_from_file(file_path, n, d, 2), std::invalid_argument);
+    }
+
+    std::remove(file_path.c_str());
+}
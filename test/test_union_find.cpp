@@ -100,4 +100,66 @@ TEST_CASE("Basic tests for Union Find data structure manipulation", "[uf:base]")
         REQUIRE(uf.get_rank(my_nodes[1]) == 2);
         REQUIRE(uf.get_rank(my_nodes[2]) == 1);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("Tests for the flat Union Find data structure", "[uf:flat]")
+{
+    FlatUnionFind uf = FlatUnionFind(10);
+
+    SECTION("Initialization")
+    {
+        REQUIRE(uf.get_parent(-1) == -1);
+        REQUIRE(uf.get_parent(10) == -1);
+        REQUIRE(uf.get_size(10) == 0);
+
+        for (int i = 0; i < 10; i ++) {
+            REQUIRE(uf.get_parent(i) == i);
+            REQUIRE(uf.get_size(i) == 1);
+            REQUIRE(uf.Find(i) == i);
+        }
+
+        REQUIRE(uf.get_num_classes() == 10);
+    }
+
+    SECTION("Union tests")
+    {
+        // be careful: here, the union is arbitrary for equal sizes (second id is the parent)
+        REQUIRE(uf.Union(0, 1) == true);
+
+        REQUIRE(uf.get_num_classes() == 9);
+        REQUIRE(uf.Find(0) == 1);
+        REQUIRE(uf.get_size(1) == 2);
+
+        // the biggest class becomes the parent
+        REQUIRE(uf.Union(0, 2) == true);
+
+        REQUIRE(uf.get_num_classes() == 8);
+        REQUIRE(uf.Find(2) == 1);
+        REQUIRE(uf.get_size(1) == 3);
+
+        // already in the same class
+        REQUIRE(uf.Union(2, 0) == false);
+        REQUIRE(uf.get_num_classes() == 8);
+    }
+
+    SECTION("Long chains are flattened")
+    {
+        FlatUnionFind chain = FlatUnionFind(100000);
+
+        for (int i = 0; i < 99999; i ++) {
+            chain.Union(i, i+1);
+        }
+
+        REQUIRE(chain.get_num_classes() == 1);
+
+        int rep = chain.Find(0);
+        int same_class = 0;
+        for (int i = 0; i < 100000; i ++) {
+            same_class += (chain.Find(i) == rep);
+        }
+
+        REQUIRE(same_class == 100000);
+
+        REQUIRE(chain.get_size(rep) == 100000);
+    }
+}